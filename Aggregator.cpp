@@ -0,0 +1,372 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Aggregator.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 19, 2026, 10:05 AM
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "Aggregator.h"
+#include "FieldDecode.h"
+
+using namespace std;
+
+static string_view trimSpaces(string_view v) {
+    size_t first = v.find_first_not_of(' ');
+    if (first == string_view::npos)
+        return string_view();
+    return v.substr(first, v.find_last_not_of(' ') - first + 1);
+}
+
+static string upper(string s) {
+    transform(s.begin(), s.end(), s.begin(), ::toupper);
+    return s;
+}
+
+// Returns the KIND_ constant for how field is decoded
+
+static int fieldKind(const DBFField &field) {
+    const DBFFieldInfo &info = field.fieldInfo;
+
+    switch (toupper(info.type)) {
+        case 'N':
+        case 'F':
+            if ((info.decimalCount == 0) && (info.length <= 18))
+                return Aggregator::KIND_INTEGER;
+            return Aggregator::KIND_REAL;
+        case 'I':
+            if (info.length == 4)
+                return Aggregator::KIND_INTEGER;
+            break;
+        case 'B':
+        case 'Y':
+            if (info.length == 8)
+                return Aggregator::KIND_REAL;
+            break;
+        case 'T':
+            if (info.length == 8)
+                return Aggregator::KIND_TIME;
+            break;
+    }
+
+    return Aggregator::KIND_TEXT;
+}
+
+// Decodes raw as a number to compare MIN and MAX values by
+
+static bool fieldNumber(const Aggregator::Column &column, string_view raw, double &out) {
+    if (column.kind != Aggregator::KIND_TIME)
+        return fieldDouble(column.field, raw, out);
+
+    DBFDateTime dt;
+    if (!fieldDateTime(column.field, raw, dt))
+        return false;
+    out = daysSinceEpoch(dt.date) * 86400000.0 + dt.millis;
+    return true;
+}
+
+// Adds l to the integer sum of v. The sum is kept in 64 bits until it
+// overflows and in 128 bits from then on.
+
+static void addInteger(Aggregator::Value &v, __int128 l) {
+    int64_t sum;
+
+    if (!v.wide && (l >= INT64_MIN) && (l <= INT64_MAX) && !__builtin_add_overflow(v.sum, (int64_t) l, &sum)) {
+        v.sum = sum;
+        return;
+    }
+
+    if (!v.wide) {
+        v.wideSum = v.sum;
+        v.wide = true;
+    }
+    v.wideSum += l;
+}
+
+Aggregator::Aggregator() {
+
+}
+
+// Resolves the comma separated groupFields and aggregates against the fields
+// of dbf. Group fields named in the -9 list of fopt are marked as base 94. No
+// aggregates means COUNT. Returns false and sets the error on failure.
+
+bool Aggregator::open(string groupFields, string aggregates, FieldOptions &fopt, DBFActor &dbf) {
+    groupBy.clear();
+    columns.clear();
+    groups.clear();
+    error = "";
+
+    stringstream groupStream(groupFields);
+    string token;
+
+    while (getline(groupStream, token, ',')) {
+        string name(trimSpaces(token));
+        FieldSelection sel;
+
+        if (!dbf.findField(name, sel.field))
+            return fail("unknown field " + name);
+        sel.name = sel.field.fieldInfo.name;
+        sel.b94 = fopt.wantsB94(upper(sel.name));
+        groupBy.push_back(sel);
+    }
+
+    if (trimSpaces(aggregates).empty())
+        aggregates = "COUNT";
+
+    stringstream aggStream(aggregates);
+
+    while (getline(aggStream, token, ',')) {
+        string spec = upper(string(trimSpaces(token)));
+        Column c = Column();
+
+        if ((spec == "COUNT") || (spec == "COUNT(*)")) {
+            c.op = AGG_COUNT;
+            c.kind = KIND_INTEGER;
+            c.name = "COUNT";
+            columns.push_back(c);
+            continue;
+        }
+
+        size_t open = spec.find('(');
+        if ((open == string::npos) || (spec.back() != ')'))
+            return fail("expected COUNT, SUM(field), MIN(field) or MAX(field) at '" + token + "'");
+
+        string op = spec.substr(0, open);
+        string name(trimSpaces(string_view(spec).substr(open + 1, spec.length() - open - 2)));
+
+        if (op == "SUM")
+            c.op = AGG_SUM;
+        else if (op == "MIN")
+            c.op = AGG_MIN;
+        else if (op == "MAX")
+            c.op = AGG_MAX;
+        else return fail("unknown aggregate " + op);
+
+        if (!dbf.findField(name, c.field))
+            return fail("unknown field " + name);
+        if (fieldIsMemo(c.field))
+            return fail("can't aggregate memo field " + name);
+
+        c.kind = fieldKind(c.field);
+        if ((c.op == AGG_SUM) && (c.kind != KIND_INTEGER) && (c.kind != KIND_REAL))
+            return fail("can't sum non numeric field " + name);
+
+        c.name = op + "(" + c.field.fieldInfo.name + ")";
+        columns.push_back(c);
+    }
+
+    return true;
+}
+
+// Resolves the fields again against another dbf, keeping the groups so far.
+// The fields may have moved, but must keep their type and length for the
+// keys to stay comparable. Returns false and sets the error if they don't,
+// leaving the fields as they were.
+
+bool Aggregator::resolve(DBFActor &dbf) {
+    auto find = [&](DBFField &field) {
+        DBFField f;
+
+        if (!dbf.findField(field.fieldInfo.name, f))
+            return fail("no field " + string(field.fieldInfo.name));
+        if ((toupper(f.fieldInfo.type) != toupper(field.fieldInfo.type)) ||
+                (f.fieldInfo.length != field.fieldInfo.length) ||
+                (f.fieldInfo.decimalCount != field.fieldInfo.decimalCount))
+            return fail("field " + string(field.fieldInfo.name) + " has a different type or length");
+
+        field = f;
+        return true;
+    };
+
+    FieldPlan resolvedGroupBy = groupBy;
+    vector<Column> resolvedColumns = columns;
+
+    error = "";
+
+    for (FieldSelection &sel : resolvedGroupBy) {
+        if (!find(sel.field))
+            return false;
+    }
+
+    for (Column &c : resolvedColumns) {
+        if ((c.op != AGG_COUNT) && !find(c.field))
+            return false;
+    }
+
+    groupBy.swap(resolvedGroupBy);
+    columns.swap(resolvedColumns);
+    return true;
+}
+
+// Empties the aggregator and gives it the fields and aggregates of layout, to
+// collect a partial aggregate that is merged into layout later
+
+void Aggregator::reset(const Aggregator &layout) {
+    groupBy = layout.groupBy;
+    columns = layout.columns;
+    groups.clear();
+    error = "";
+}
+
+void Aggregator::add(const DBFRecordView &rec) {
+    key.clear();
+    for (const FieldSelection &sel : groupBy)
+        key.append(rec.get(sel.field));
+
+    auto it = groups.find(key);
+    if (it == groups.end()) {
+        Group g;
+        g.count = 0;
+        g.values.resize(columns.size());
+        it = groups.emplace(key, move(g)).first;
+    }
+
+    Group &g = it->second;
+    g.count++;
+
+    for (size_t i = 0; i < columns.size(); i++) {
+        const Column &c = columns[i];
+        Value &v = g.values[i];
+
+        if (c.op == AGG_COUNT)
+            continue;
+
+        string_view raw = rec.get(c.field);
+
+        if (c.op == AGG_SUM) {
+            int64_t l;
+            double d;
+
+            if (c.kind == KIND_INTEGER) {
+                if (fieldInt64(c.field, raw, l)) {
+                    addInteger(v, l);
+                    v.set = true;
+                }
+            } else if (fieldDouble(c.field, raw, d)) {
+                v.number += d;
+                v.set = true;
+            }
+            continue;
+        }
+
+        bool better;
+
+        if (c.kind == KIND_TEXT) {
+            string_view t = trimSpaces(raw);
+            if (t.empty())
+                continue;
+            better = !v.set || ((c.op == AGG_MIN) ? (t < trimSpaces(v.raw)) : (t > trimSpaces(v.raw)));
+        } else {
+            double d;
+            if (!fieldNumber(c, raw, d))
+                continue;
+            better = !v.set || ((c.op == AGG_MIN) ? (d < v.number) : (d > v.number));
+            if (better)
+                v.number = d;
+        }
+
+        if (better) {
+            v.raw.assign(raw);
+            v.set = true;
+        }
+    }
+}
+
+// Adds the groups of other, a partial aggregate with the same layout
+
+void Aggregator::merge(const Aggregator &other) {
+    for (const auto &entry : other.groups) {
+        auto it = groups.find(entry.first);
+        if (it == groups.end()) {
+            groups.insert(entry);
+            continue;
+        }
+
+        Group &g = it->second;
+        g.count += entry.second.count;
+        for (size_t i = 0; i < columns.size(); i++)
+            combine(columns[i], g.values[i], entry.second.values[i]);
+    }
+}
+
+const FieldPlan &Aggregator::getGroupBy() const {
+    return groupBy;
+}
+
+const vector<Aggregator::Column> &Aggregator::getColumns() const {
+    return columns;
+}
+
+const unordered_map<string, Aggregator::Group> &Aggregator::getGroups() const {
+    return groups;
+}
+
+// Returns the raw data of group field index within a group key
+
+string_view Aggregator::groupValue(string_view groupKey, size_t index) const {
+    size_t offset = 0;
+
+    for (size_t i = 0; i < index; i++)
+        offset += groupBy[i].field.fieldInfo.length;
+
+    return groupKey.substr(offset, groupBy[index].field.fieldInfo.length);
+}
+
+string Aggregator::getError() {
+    return error;
+}
+
+bool Aggregator::fail(string message) {
+    error = message;
+    return false;
+}
+
+void Aggregator::combine(const Column &column, Value &into, const Value &from) const {
+    if (!from.set || (column.op == AGG_COUNT))
+        return;
+
+    if (column.op == AGG_SUM) {
+        addInteger(into, from.wide ? from.wideSum : from.sum);
+        into.number += from.number;
+        into.set = true;
+        return;
+    }
+
+    bool better;
+
+    if (!into.set)
+        better = true;
+    else if (column.kind == KIND_TEXT) {
+        string_view a = trimSpaces(from.raw);
+        string_view b = trimSpaces(into.raw);
+        better = (column.op == AGG_MIN) ? (a < b) : (a > b);
+    } else better = (column.op == AGG_MIN) ? (from.number < into.number) : (from.number > into.number);
+
+    if (better)
+        into = from;
+}
@@ -0,0 +1,108 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Aggregator.h
+ * Author: Heath Leach
+ *
+ * Created on October 19, 2026, 10:05 AM
+ */
+
+#ifndef AGGREGATOR_H
+#define	AGGREGATOR_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+#include "DBFActor.h"
+#include "FieldOptions.h"
+
+// COUNT, SUM, MIN and MAX of records grouped by the values of some of their
+// fields, worked out from the raw record data. Groups are keyed on the raw
+// bytes of the group fields, spaces and all, so adding a record only decodes
+// the fields being summed or compared. Each thread of a parallel dump keeps
+// its own partial Aggregator, and the partials are merged at the end.
+//
+//     COUNT       Number of records in the group
+//     SUM(NAME)   Sum of a numeric field, blank values left out
+//     MIN(NAME)   Smallest value of a field: numbers and date times by
+//     MAX(NAME)   value, everything else byte by byte after trimming spaces
+
+class Aggregator {
+public:
+    static const int AGG_COUNT = 0;
+    static const int AGG_SUM = 1;
+    static const int AGG_MIN = 2;
+    static const int AGG_MAX = 3;
+
+    static const int KIND_INTEGER = 0; // Whole numbers, summed exactly
+    static const int KIND_REAL = 1; // Other numbers
+    static const int KIND_TIME = 2; // Visual FoxPro date times
+    static const int KIND_TEXT = 3; // Everything else
+
+    struct Column {
+        int op; // One of the AGG_ constants
+        int kind; // One of the KIND_ constants, how the field is decoded
+        DBFField field; // Field aggregated, unused by COUNT
+        std::string name; // Column heading, such as SUM(AMT)
+    };
+
+    struct Value {
+        bool set; // A value has been aggregated
+        int64_t sum; // SUM of a KIND_INTEGER field while it fits
+        bool wide; // sum overflowed and the SUM is kept in wideSum instead
+        __int128 wideSum; // SUM of a KIND_INTEGER field once it didn't fit
+        double number; // SUM of a KIND_REAL field, or the MIN or MAX number
+        std::string raw; // Raw field data of the MIN or MAX
+    };
+
+    struct Group {
+        uint64_t count; // Records in the group
+        std::vector<Value> values; // One per column
+    };
+private:
+    FieldPlan groupBy; // Fields the records are grouped by
+    std::vector<Column> columns; // Aggregates worked out for each group
+    std::unordered_map<std::string, Group> groups; // Groups by their raw key
+    std::string key; // Key of the record being added
+    std::string error; // Description of the last open error
+public:
+    Aggregator();
+    bool open(std::string groupFields, std::string aggregates, FieldOptions &fopt, DBFActor &dbf);
+    bool resolve(DBFActor &dbf);
+    void reset(const Aggregator &layout);
+    void add(const DBFRecordView &rec);
+    void merge(const Aggregator &other);
+    const FieldPlan &getGroupBy() const;
+    const std::vector<Column> &getColumns() const;
+    const std::unordered_map<std::string, Group> &getGroups() const;
+    std::string_view groupValue(std::string_view groupKey, size_t index) const;
+    std::string getError();
+private:
+    bool fail(std::string message);
+    void combine(const Column &column, Value &into, const Value &from) const;
+};
+
+#endif	/* AGGREGATOR_H */
@@ -0,0 +1,72 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Arena.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 20, 2026, 10:15 AM
+ */
+
+#include <cstring>
+#include "Arena.h"
+
+using namespace std;
+
+Arena::Arena() {
+    current = 0;
+    used = 0;
+}
+
+// Returns size bytes that stay valid until the next reset()
+
+char *Arena::alloc(size_t size) {
+    while (current < chunks.size()) {
+        Chunk &c = chunks[current];
+        if (c.size - used >= size) {
+            char *p = c.data.get() + used;
+            used += size;
+            return p;
+        }
+        current++;
+        used = 0;
+    }
+
+    Chunk c;
+    c.size = (size > CHUNK_SIZE) ? size : CHUNK_SIZE;
+    c.data.reset(new char[c.size]);
+    chunks.push_back(move(c));
+    used = size;
+    return chunks.back().data.get();
+}
+
+string_view Arena::copy(string_view v) {
+    char *p = alloc(v.length());
+    memcpy(p, v.data(), v.length());
+    return string_view(p, v.length());
+}
+
+void Arena::reset() {
+    current = 0;
+    used = 0;
+}
@@ -0,0 +1,62 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Arena.h
+ * Author: Heath Leach
+ *
+ * Created on October 20, 2026, 10:15 AM
+ */
+
+#ifndef ARENA_H
+#define	ARENA_H
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// A bump allocator for the short lived text made while formatting a block of
+// records, such as base 94 values with their quotes doubled. Everything it
+// hands out is freed at once by reset(), which keeps the memory for the next
+// block, so once the chunks have grown to fit a block the dump loops make no
+// heap allocations per record.
+
+class Arena {
+public:
+    static const size_t CHUNK_SIZE = 64 * 1024;
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data; // Memory handed out from
+        size_t size; // Bytes in data
+    };
+    std::vector<Chunk> chunks; // Kept across resets
+    size_t current; // Chunk being handed out from
+    size_t used; // Bytes of the current chunk handed out
+public:
+    Arena();
+    char *alloc(size_t size);
+    std::string_view copy(std::string_view v);
+    void reset();
+};
+
+#endif	/* ARENA_H */
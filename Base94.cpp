@@ -0,0 +1,176 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Base94.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 16, 2026, 9:40 PM
+ */
+
+#include <cstring>
+#include <limits>
+#include "Base94.h"
+
+using namespace std;
+
+static const uint64_t ONES = 0x0101010101010101ULL;
+static const uint64_t HIGHS = 0x8080808080808080ULL;
+
+uint8_t decodeBase94(string_view b94, uint64_t &value) {
+    const uint64_t MAX_VALUE = numeric_limits<uint64_t>::max();
+    uint64_t count = 0;
+
+    for (size_t i = 0; i < b94.length(); i++) {
+        uint64_t val = (uint8_t) b94[i] - 33;
+        if (val > 93)
+            return B94_INVALID;
+        if (count > (MAX_VALUE / 94))
+            return B94_OVERFLOW;
+        count *= 94;
+        if ((MAX_VALUE - count) < val)
+            return B94_OVERFLOW;
+        count += val;
+    }
+
+    value = count;
+    return B94_VALID;
+}
+
+#if defined(__SIZEOF_INT128__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define BASE94_WIDE
+typedef unsigned __int128 uint128;
+
+static const uint128 SPACES = ((uint128) (ONES * ' ') << 64) | (ONES * ' ');
+static const uint128 LOWS = ((uint128) (ONES * 0x7F) << 64) | (ONES * 0x7F);
+#endif
+
+// Decodes 8 digits held one per byte, most significant in the low byte, by
+// combining neighbouring lanes. Returns false if any byte isn't a digit.
+
+static bool decodeWord(uint64_t word, uint64_t &value) {
+    // Any byte below '!' or above '~'
+    uint64_t below = (word - ONES * 33) & ~word & HIGHS;
+    uint64_t above = ((word + ONES) | word) & HIGHS;
+    if (below | above)
+        return false;
+
+    word -= ONES * 33;
+    word = (word & 0x00FF00FF00FF00FFULL) * 94 + ((word >> 8) & 0x00FF00FF00FF00FFULL);
+    word = (word & 0x0000FFFF0000FFFFULL) * (94 * 94) + ((word >> 16) & 0x0000FFFF0000FFFFULL);
+    value = (word & 0xFFFFFFFFULL) * (94ULL * 94 * 94 * 94) + (word >> 32);
+    return true;
+}
+
+// Trims a field of spaces and decodes it a byte at a time
+
+static uint8_t decodeTrimmed(const char *field, uint8_t length, uint64_t &value) {
+    const char *first = field;
+    const char *last = field + length;
+
+    while ((first < last) && (*first == ' '))
+        first++;
+    while ((last > first) && (last[-1] == ' '))
+        last--;
+
+    return decodeBase94(string_view(first, last - first), value);
+}
+
+#ifdef BASE94_WIDE
+
+// Decodes a field of up to 16 bytes held in v, padded with spaces, finding
+// the value within the field from a mask of its non space bytes instead of
+// scanning for it. Returns false if the trimmed value is over 9 digits.
+
+static bool decodeShort(uint128 v, uint64_t &value, uint8_t &result) {
+    uint128 x = v ^ SPACES;
+    uint128 set = (((x & LOWS) + LOWS) | x) & ~LOWS;
+
+    if (set == 0) {
+        value = 0;
+        result = B94_VALID;
+        return true;
+    }
+
+    uint64_t setLow = set;
+    uint64_t setHigh = set >> 64;
+    int first = (setLow ? __builtin_ctzll(setLow) : 64 + __builtin_ctzll(setHigh)) >> 3;
+    int last = (setHigh ? 127 - __builtin_clzll(setHigh) : 63 - __builtin_clzll(setLow)) >> 3;
+    int n = last - first + 1;
+
+    if (n > 9)
+        return false;
+
+    // Move the last digit to the top byte, then left pad the 8 digits
+    // ending there to 8 with zeros ('!'), taking a 9th digit apart
+    uint128 w = v << ((15 - last) * 8);
+    uint64_t word = w >> 64;
+    uint64_t top = (n == 9) ? (uint64_t) (uint8_t) (w >> 56) - 33 : 0;
+    uint64_t keep = (n == 9) ? ~0ULL : ~0ULL << ((8 - n) * 8);
+    word = (word & keep) | (ONES * '!' & ~keep);
+
+    if ((top > 93) || !decodeWord(word, value))
+        result = B94_INVALID;
+    else {
+        value += top * 6095689385410816ULL;
+        result = B94_VALID;
+    }
+
+    return true;
+}
+
+#endif
+
+void decodeBase94Block(const DBFBlock &block, uint16_t offset, uint8_t length,
+        const vector<uint8_t> &hits, uint64_t *values, uint8_t *results,
+        size_t stride) {
+    const char *field = block.data + offset;
+
+#ifdef BASE94_WIDE
+    // Whole 16 byte loads are only safe up to the end of the block
+    const char *end = block.data + (size_t) block.count * block.recordLength;
+    uint128 mask = (length < 16) ? ((uint128) 1 << (length * 8)) - 1 : ~(uint128) 0;
+#endif
+
+    for (uint32_t i = 0; i < block.count; i++, field += block.recordLength) {
+        if (!hits[i])
+            continue;
+
+        uint64_t &value = values[i * stride];
+        uint8_t &result = results[i * stride];
+
+#ifdef BASE94_WIDE
+        if (length <= 16) {
+            uint128 v = 0;
+            if (field + 16 <= end)
+                memcpy(&v, field, 16);
+            else memcpy(&v, field, length);
+
+            if (decodeShort((v & mask) | (SPACES & ~mask), value, result))
+                continue;
+        }
+#endif
+
+        result = decodeTrimmed(field, length, value);
+    }
+}
@@ -0,0 +1,64 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Base94.h
+ * Author: Heath Leach
+ *
+ * Created on October 16, 2026, 9:40 PM
+ */
+
+#ifndef BASE94_H
+#define	BASE94_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "DBFActor.h"
+
+// Results of decoding a base 94 value
+
+const uint8_t B94_VALID = 0;
+const uint8_t B94_INVALID = 1;
+const uint8_t B94_OVERFLOW = 2;
+
+// Decodes b94, digits '!' (0) to '~' (93) most significant first, into
+// value. Returns B94_INVALID at the first byte outside the digit range and
+// B94_OVERFLOW as soon as the value no longer fits in 64 bits, whichever
+// comes first. An empty value decodes to 0.
+
+uint8_t decodeBase94(std::string_view b94, uint64_t &value);
+
+// Decodes the field at offset, of length bytes, of every record i of block
+// with hits[i] set, trimmed of spaces, into values[i * stride] and
+// results[i * stride]. Fields of up to 16 bytes are loaded whole and
+// trimmed with a mask, and values of up to 9 digits, which can't overflow,
+// are checked and decoded 8 digits at a time in a 64 bit word. Everything
+// else, and all fields where 128 bit integers aren't available, goes through
+// decodeBase94.
+
+void decodeBase94Block(const DBFBlock &block, uint16_t offset, uint8_t length,
+        const std::vector<uint8_t> &hits, uint64_t *values, uint8_t *results,
+        size_t stride);
+
+#endif	/* BASE94_H */
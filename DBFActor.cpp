@@ -28,76 +28,467 @@
  * Created on March 1, 2015, 6:13 PM
  */
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "DBFActor.h"
+#include "Decompressor.h"
+#include "FieldDecode.h"
+#include "ReadAhead.h"
 
 using namespace std;
 
 #define DO_FAIL(err) setStatus(err, __LINE__, __FILE__)
 
+// Sets the date of last update in header to today
+
+static void stampToday(DBFHeader &header) {
+    time_t now = time(NULL);
+    struct tm today;
+    localtime_r(&now, &today);
+
+    header.lastUpdated[0] = today.tm_year;
+    header.lastUpdated[1] = today.tm_mon + 1;
+    header.lastUpdated[2] = today.tm_mday;
+}
+
+static uint64_t nanosSince(chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+}
+
 DBFActor::DBFActor(string fileName, bool throwErrors) {
     this->throwErrors = throwErrors;
+    map = NULL;
+    streamFd = -1;
+    appended = 0;
+    appendWritten = 0;
+    skipDeleted = false;
+    blockSize = DEFAULT_BLOCK_SIZE;
+    aheadDepth = 0;
+    aheadFirst = 0;
+    schemaReused = false;
+    current.count = 0;
+    ioStats = DBFIOStats();
     open(fileName);
 }
 
 DBFActor::DBFActor(string fileName) {
     throwErrors = false;
+    map = NULL;
+    streamFd = -1;
+    appended = 0;
+    appendWritten = 0;
+    skipDeleted = false;
+    blockSize = DEFAULT_BLOCK_SIZE;
+    aheadDepth = 0;
+    aheadFirst = 0;
+    schemaReused = false;
+    current.count = 0;
+    ioStats = DBFIOStats();
     open(fileName);
 }
 
 DBFActor::DBFActor() {
     throwErrors = false;
+    map = NULL;
+    streamFd = -1;
+    appended = 0;
+    appendWritten = 0;
+    skipDeleted = false;
+    blockSize = DEFAULT_BLOCK_SIZE;
+    aheadDepth = 0;
+    aheadFirst = 0;
+    schemaReused = false;
+    current.count = 0;
+    ioStats = DBFIOStats();
     setStatus(STATUS_CLOSED, 0, "");
 }
 
 DBFActor::DBFActor(bool throwErrors) {
     this->throwErrors = throwErrors;
+    map = NULL;
+    streamFd = -1;
+    appended = 0;
+    appendWritten = 0;
+    skipDeleted = false;
+    blockSize = DEFAULT_BLOCK_SIZE;
+    aheadDepth = 0;
+    aheadFirst = 0;
+    schemaReused = false;
+    current.count = 0;
+    ioStats = DBFIOStats();
     setStatus(STATUS_CLOSED, 0, "");
 }
 
+DBFActor::~DBFActor() {
+    unmap();
+}
+
 void DBFActor::open(string fileName) {
+    auto start = chrono::steady_clock::now();
+    ioStats = DBFIOStats();
     setStatus(STATUS_READY, 0, "");
+    unmap();
+    stopAhead();
+    path = fileName;
+    appendBuffer.clear();
+    appended = 0;
+    appendWritten = 0;
+    streamFd = -1;
+    inflater.reset();
+
+    if (file.is_open())
+        file.close();
 
+    // Files that can't be written to can still be read
     file.open(fileName.c_str(), ios::in | ios::binary | ios::out);
-    file.read((char *) &header, sizeof (DBFHeader));
+    if (!file.is_open()) {
+        file.clear();
+        file.open(fileName.c_str(), ios::in | ios::binary);
+    }
 
-    if (file.fail()) {
+    // The header, field descriptors and anything else up to the first record
+    // come in with a single read unless there are a great many fields
+    RecordVec head(HEADER_READ_SIZE);
+    file.read(head.data(), head.size());
+    size_t got = file.gcount();
+    countRead(got);
+    file.clear();
+
+    // Compressed files are decompressed on another thread and read as a
+    // stream
+    if (Decompressor::detect(head.data(), got) != Decompressor::FORMAT_NONE) {
+        file.close();
+        inflater.reset(new Decompressor());
+
+        if (!inflater->open(fileName)) {
+            int err = errno;
+            bool missing = inflater->commandMissing();
+            inflater.reset();
+            errno = err;
+            DO_FAIL(missing ? STATUS_NO_DECOMPRESSOR : STATUS_FAILED_TO_OPEN);
+            if (throwErrors)
+                throw status;
+            return;
+        }
+
+        readStreamHeader();
+        ioStats.headerNanos = nanosSince(start);
+        openMemo(fileName);
+        return;
+    }
+
+    if (got < sizeof (DBFHeader)) {
         DO_FAIL(STATUS_FAILED_TO_OPEN);
         if (throwErrors)
             throw status;
         return;
     }
 
-    bool loop = true;
-    uint16_t offset = 0;
-    uint16_t number = 0;
+    memcpy(&header, head.data(), sizeof (DBFHeader));
 
-    while (loop) {
-        DBFField field;
-        file.read((char *) &(field.fieldInfo), sizeof (DBFFieldInfo));
+    size_t end = max((size_t) header.posFirstRecord, sizeof (DBFHeader));
+    if (got < end) {
+        head.resize(end);
+        file.read(head.data() + got, end - got);
+        got += file.gcount();
+        countRead(file.gcount());
+        file.clear();
+    }
 
-        bool endOfFields = (field.fieldInfo.name[0] == HEADER_RECORD_TERMINATOR);
+    RecordVec descriptors(head.begin() + sizeof (DBFHeader), head.begin() + min(got, end));
 
-        if ((file.fail() && !file.eof()) || (file.eof() && !endOfFields)) {
-            DO_FAIL(STATUS_FAILED_TO_READ);
-            if (throwErrors)
-                throw status;
+    if ((got < end) || !loadFields(descriptors)) {
+        DO_FAIL(STATUS_FAILED_TO_READ);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    ioStats.headerNanos = nanosSince(start);
+    openMemo(fileName);
+    reset();
+}
+
+// Opens the file read only and maps the whole of it into memory. Records are
+// then located by pointer arithmetic instead of seeking and reading through
+// the stream, and mappedRecord() hands out pointers straight into the mapping.
+// Compressed files can't be mapped and are opened with open() instead.
+
+void DBFActor::openMapped(string fileName) {
+    if (Decompressor::detect(fileName) != Decompressor::FORMAT_NONE) {
+        open(fileName);
+        return;
+    }
+
+    auto start = chrono::steady_clock::now();
+    ioStats = DBFIOStats();
+    setStatus(STATUS_READY, 0, "");
+    unmap();
+    stopAhead();
+    streamFd = -1;
+    inflater.reset();
+    if (file.is_open())
+        file.close();
+    appendBuffer.clear();
+    appended = 0;
+    appendWritten = 0;
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    struct stat st;
+
+    if ((fd < 0) || (fstat(fd, &st) != 0) || (st.st_size < (off_t) sizeof (DBFHeader))) {
+        DO_FAIL(STATUS_FAILED_TO_OPEN);
+        if (fd >= 0)
+            ::close(fd);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (m == MAP_FAILED) {
+        DO_FAIL(STATUS_FAILED_TO_OPEN);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    map = (char *) m;
+    mapSize = st.st_size;
+    madvise(map, mapSize, MADV_SEQUENTIAL);
+
+    memcpy(&header, map, sizeof (DBFHeader));
+
+    RecordVec descriptors;
+    if (header.posFirstRecord <= mapSize)
+        descriptors.assign(map + sizeof (DBFHeader), map + max((size_t) header.posFirstRecord, sizeof (DBFHeader)));
+
+    if ((header.posFirstRecord > mapSize) || !loadFields(descriptors)) {
+        DO_FAIL(STATUS_FAILED_TO_READ);
+        unmap();
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    ioStats.bytesRead = sizeof (DBFHeader) + headerData.size();
+    ioStats.headerNanos = nanosSince(start);
+    openMemo(fileName);
+    reset();
+}
+
+// Reads the dbf forward only from fd, such as stdin or a pipe, that can't
+// seek. The header and field descriptors are parsed off the front of the
+// stream and records are then read in order. Seeking forwards skips over
+// records, while reset() and seeking backwards fail once records have been
+// read. fd is not closed by the DBFActor.
+
+void DBFActor::openStream(int fd) {
+    auto start = chrono::steady_clock::now();
+    ioStats = DBFIOStats();
+    setStatus(STATUS_READY, 0, "");
+    unmap();
+    stopAhead();
+    memo.close();
+    appendBuffer.clear();
+    appended = 0;
+    appendWritten = 0;
+    inflater.reset();
+    if (file.is_open())
+        file.close();
+
+    streamFd = fd;
+    readStreamHeader();
+    ioStats.headerNanos = nanosSince(start);
+}
+
+// Parses the header and field descriptors off the front of the stream
+
+void DBFActor::readStreamHeader() {
+    streamPos = 0;
+    streamEnd = false;
+
+    if (streamRead((char *) &header, sizeof (DBFHeader)) != sizeof (DBFHeader)) {
+        DO_FAIL(STATUS_FAILED_TO_OPEN);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    RecordVec descriptors(header.posFirstRecord > sizeof (DBFHeader) ? header.posFirstRecord - sizeof (DBFHeader) : 0);
+
+    if ((streamRead(descriptors.data(), descriptors.size()) != descriptors.size()) ||
+            !loadFields(descriptors)) {
+        DO_FAIL(STATUS_FAILED_TO_READ);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    reset();
+}
+
+// Maps the memo file of the dbf if it has memo fields. A missing memo file
+// isn't an error; the memos just read back empty.
+
+void DBFActor::openMemo(const string &fileName) {
+    memo.close();
+
+    for (const DBFField &field : fieldList) {
+        if (fieldIsMemo(field)) {
+            memo.open(fileName);
             return;
         }
+    }
+}
+
+bool DBFActor::isMapped() {
+    return map != NULL;
+}
+
+// True if the dbf is read forward only, from openStream() or a compressed
+// file
+
+bool DBFActor::isStream() {
+    return (streamFd >= 0) || inflater;
+}
 
-        if (endOfFields) {
-            loop = false;
-            fieldCount = number;
-        } else {
-            number++;
-            field.fieldNumber = number;
-            field.fieldOffset = offset;
-            offset += field.fieldInfo.length;
-            fields[field.fieldInfo.name] = field;
+// Reads up to len bytes from the stream, stopping short only at the end of
+// the stream or on an error, which also sets the status. Returns the number
+// of bytes read.
+
+size_t DBFActor::streamRead(char *buf, size_t len) {
+    size_t got = 0;
+    bool failed = false;
+
+    if (inflater) {
+        got = inflater->read(buf, len);
+        countRead(got);
+        failed = (got < len) && inflater->fail();
+    } else {
+        while (got < len) {
+            ssize_t n = ::read(streamFd, buf + got, len - got);
+            countRead(n > 0 ? n : 0);
+            if ((n < 0) && (errno == EINTR))
+                continue;
+            if (n <= 0) {
+                failed = (n < 0);
+                break;
+            }
+            got += n;
         }
     }
 
-    reset();
+    if (got > 0)
+        streamLast = buf[got - 1];
+
+    if (got < len)
+        streamEnd = true;
+    if (failed)
+        DO_FAIL(STATUS_FAILED_TO_READ);
+
+    streamPos += got;
+    return got;
+}
+
+// Moves the stream forward to byte pos by reading and discarding. Returns
+// false if pos is behind the stream or the stream ends first.
+
+bool DBFActor::streamSkip(uint64_t pos) {
+    char skip[4096];
+
+    if (pos < streamPos)
+        return false;
+
+    while (streamPos < pos) {
+        size_t len = min((uint64_t) sizeof (skip), pos - streamPos);
+        if (streamRead(skip, len) != len)
+            return false;
+    }
+
+    return true;
+}
+
+// Builds the field map from the raw field descriptors following the header.
+// Returns false if the descriptors run past the end of the buffer before the
+// terminator is found.
+
+bool DBFActor::parseFields(const char *buf, uint64_t size) {
+    uint64_t pos = 0;
+    uint16_t offset = 0;
+    uint16_t number = 0;
+
+    fields.clear();
+    fieldList.clear();
+
+    while ((pos < size) && ((unsigned char) buf[pos] != HEADER_RECORD_TERMINATOR)) {
+        if (pos + sizeof (DBFFieldInfo) > size)
+            return false;
+
+        DBFField field;
+        memcpy(&(field.fieldInfo), buf + pos, sizeof (DBFFieldInfo));
+        pos += sizeof (DBFFieldInfo);
+
+        number++;
+        field.fieldNumber = number;
+        field.fieldOffset = offset;
+        offset += field.fieldInfo.length;
+        fields[field.fieldInfo.name] = field;
+        fieldList.push_back(field);
+    }
+
+    fieldCount = number;
+    return pos < size;
+}
+
+// Takes descriptors, the raw bytes between the header and the first record,
+// as the schema of the file. When they are the same as the previous file's
+// the fields parsed from that file are kept, so that a run of files with the
+// same layout only parses it once. Returns false if they can't be parsed.
+
+bool DBFActor::loadFields(RecordVec &descriptors) {
+    schemaReused = !fieldList.empty() && (descriptors == headerData);
+
+    if (!schemaReused && !parseFields(descriptors.data(), descriptors.size())) {
+        fields.clear();
+        fieldList.clear();
+        headerData.clear();
+        return false;
+    }
+
+    headerData.swap(descriptors);
+    return true;
+}
+
+// True if the file last opened had the same field descriptors as the one
+// before it, so that its fields, and anything resolved against them, are
+// unchanged
+
+bool DBFActor::sameSchema() {
+    return schemaReused;
+}
+
+// Returns the raw field descriptors of the file last opened
+
+const RecordVec &DBFActor::getDescriptors() {
+    return headerData;
+}
+
+void DBFActor::unmap() {
+    if (map != NULL)
+        munmap(map, mapSize);
+    map = NULL;
+    mapSize = 0;
 }
 
 void DBFActor::setStatus(int err, int line, const char *file) {
@@ -107,10 +498,30 @@ void DBFActor::setStatus(int err, int line, const char *file) {
     status.srcFile = file;
 }
 
+void DBFActor::countRead(uint64_t bytes) {
+    ioStats.readCalls++;
+    ioStats.bytesRead += bytes;
+}
+
 void DBFActor::reset() {
     if (status.error != STATUS_READY)
         return;
 
+    cursor = 0;
+    current.count = 0;
+
+    if (map != NULL)
+        return;
+
+    if (isStream()) {
+        if (streamPos > (uint64_t) header.posFirstRecord + 1) {
+            DO_FAIL(STATUS_FAILED_TO_SEEK);
+            if (throwErrors)
+                throw status;
+        }
+        return;
+    }
+
     file.clear();
     file.seekg(header.posFirstRecord + 1);
 
@@ -121,13 +532,21 @@ void DBFActor::reset() {
         return;
     }
 
+    fileRecord = 0;
 }
 
 void DBFActor::seekRecord(uint32_t record) {
     if (status.error != STATUS_READY)
         return;
 
-    uint64_t pos = header.posFirstRecord + 1 + (record * header.recordLength);
+    cursor = record;
+
+    // Streams move on the next read, which may still be served from the
+    // current block
+    if ((map != NULL) || isStream())
+        return;
+
+    uint64_t pos = header.posFirstRecord + 1 + ((uint64_t) record * header.recordLength);
 
     file.clear();
     file.seekg(pos);
@@ -139,6 +558,7 @@ void DBFActor::seekRecord(uint32_t record) {
         return;
     }
 
+    fileRecord = record;
 }
 
 // Responsibility of the caller to make sure their buffer is >= record length
@@ -147,7 +567,40 @@ void DBFActor::readRawRecord(char *buf) {
     if (status.error != STATUS_READY)
         return;
 
+    if (map != NULL) {
+        const char *rec = mappedRecord(cursor);
+        if (rec == NULL) {
+            DO_FAIL(STATUS_FAILED_TO_READ);
+            if (throwErrors)
+                throw status;
+            return;
+        }
+        memcpy(buf, rec, header.recordLength);
+        ioStats.bytesRead += header.recordLength;
+        cursor++;
+        return;
+    }
+
+    if (isStream()) {
+        uint64_t pos = header.posFirstRecord + 1 + ((uint64_t) cursor * header.recordLength);
+        if (!streamSkip(pos) || (streamRead(buf, header.recordLength) != header.recordLength)) {
+            DO_FAIL(STATUS_FAILED_TO_READ);
+            if (throwErrors)
+                throw status;
+            return;
+        }
+        cursor++;
+        return;
+    }
+
+    if (fileRecord != cursor) {
+        seekRecord(cursor);
+        if (status.error != STATUS_READY)
+            return;
+    }
+
     file.read(buf, header.recordLength);
+    countRead(file.gcount());
 
     if (file.fail()) {
         DO_FAIL(STATUS_FAILED_TO_READ);
@@ -155,6 +608,194 @@ void DBFActor::readRawRecord(char *buf) {
             throw status;
         return;
     }
+
+    cursor++;
+    fileRecord++;
+}
+
+// Reads the next run of records starting at the cursor with a single I/O
+// call and moves the cursor past them. Returns a block with a count of 0
+// once all records have been read or if the read fails.
+
+DBFBlock DBFActor::readBlock() {
+    DBFBlock block = fillBlock(cursor, UINT32_MAX);
+    cursor += block.count;
+    current.count = 0;
+    return block;
+}
+
+// Sets the size in bytes of the reads done by readBlock() and the sequential
+// getRecordView(). A block always holds at least one record.
+
+void DBFActor::setBlockSize(size_t bytes) {
+    blockSize = bytes;
+    current.count = 0;
+    stopAhead();
+}
+
+// Keeps block reads in flight on other threads ahead of readBlock() and
+// the sequential getRecordView(), for files opened with open(), so that
+// reading overlaps with working through the records. Blocks are handed out
+// of the read ahead buffers without copying. 0, the default, reads on the
+// calling thread.
+
+void DBFActor::setReadAhead(unsigned reads) {
+    aheadDepth = reads;
+    current.count = 0;
+    stopAhead();
+
+    if ((reads > 0) && !ahead)
+        ahead.reset(new ReadAhead());
+}
+
+void DBFActor::stopAhead() {
+    if (ahead)
+        ahead->stop();
+}
+
+DBFBlock DBFActor::fillBlock(uint32_t first, uint32_t limit) {
+    DBFBlock block;
+    block.fields = &fields;
+    block.data = NULL;
+    block.first = first;
+    block.count = 0;
+    block.recordLength = header.recordLength;
+
+    if ((status.error != STATUS_READY) || (first >= header.numRecords) || (header.recordLength == 0))
+        return block;
+
+    uint32_t count = blockSize / header.recordLength;
+    if (count == 0)
+        count = 1;
+    if (count > limit)
+        count = limit;
+    if (count > header.numRecords - first)
+        count = header.numRecords - first;
+
+    uint64_t pos = header.posFirstRecord + 1 + ((uint64_t) first * header.recordLength);
+
+    if (map != NULL) {
+        uint64_t avail = pos > mapSize ? 0 : (mapSize - pos) / header.recordLength;
+        if (count > avail)
+            count = avail;
+        block.data = map + pos;
+        block.count = count;
+        ioStats.bytesRead += (uint64_t) count * header.recordLength;
+        return block;
+    }
+
+    if ((aheadDepth > 0) && (limit == UINT32_MAX) && !isStream())
+        return aheadBlock(block, pos, count);
+
+    // Reads start on the deletion flag of the first record, so that every
+    // record in the block has its flag in the byte before its data
+    blockBuffer.resize((size_t) count * header.recordLength + 1);
+    block.data = blockBuffer.data() + 1;
+    size_t got;
+
+    if (isStream()) {
+        // Whatever is left after a short read is only a partial record
+        if (streamEnd)
+            return block;
+
+        if (streamPos == pos) {
+            // The flag was the last byte of the previous read
+            blockBuffer[0] = streamLast;
+            got = 1 + streamRead(blockBuffer.data() + 1, blockBuffer.size() - 1);
+        } else if (streamSkip(pos - 1))
+            got = streamRead(blockBuffer.data(), blockBuffer.size());
+        else {
+            // Running out of stream while skipping just means no more records
+            if (streamEnd)
+                return block;
+            DO_FAIL(STATUS_FAILED_TO_SEEK);
+            if (throwErrors)
+                throw status;
+            return block;
+        }
+
+        block.count = got > 0 ? (got - 1) / header.recordLength : 0;
+
+        if ((status.error != STATUS_READY) && throwErrors)
+            throw status;
+        return block;
+    }
+
+    file.clear();
+    file.seekg(pos - 1);
+    if ((file.tellg() != streampos(pos - 1)) || (file.fail())) {
+        DO_FAIL(STATUS_FAILED_TO_SEEK);
+        if (throwErrors)
+            throw status;
+        return block;
+    }
+
+    file.read(blockBuffer.data(), blockBuffer.size());
+    got = file.gcount();
+    countRead(got);
+
+    // A short read past the last full record leaves the stream at an
+    // unknown record, so force a seek on the next read.
+    block.count = got > 0 ? (got - 1) / header.recordLength : 0;
+    fileRecord = file.fail() ? UINT32_MAX : first + block.count;
+
+    return block;
+}
+
+// Fills block, of count records from the one whose data is at pos, with the
+// next chunk from the read ahead threads. They read blocks of the same size
+// as fillBlock() from the record they were started at, and are restarted at
+// block.first if the cursor has been moved since.
+
+DBFBlock DBFActor::aheadBlock(DBFBlock block, uint64_t pos, uint32_t count) {
+    uint32_t chunkRecords = max<size_t>(blockSize / header.recordLength, 1);
+
+    if (!ahead->isRunning() || (aheadFirst != block.first)) {
+        uint64_t chunks = (header.numRecords - block.first + (uint64_t) chunkRecords - 1) / chunkRecords;
+        size_t step = (size_t) chunkRecords * header.recordLength;
+
+        if (!ahead->start(path, pos - 1, step, step + 1, chunks, aheadDepth)) {
+            DO_FAIL(STATUS_FAILED_TO_READ);
+            if (throwErrors)
+                throw status;
+            return block;
+        }
+        aheadFirst = block.first;
+    }
+
+    size_t got;
+    const char *chunk = ahead->next(got);
+
+    if (chunk == NULL) {
+        if (ahead->fail()) {
+            DO_FAIL(STATUS_FAILED_TO_READ);
+            if (throwErrors)
+                throw status;
+        }
+        return block;
+    }
+
+    countRead(got);
+    block.data = chunk + 1;
+    block.count = got > 0 ? min<uint64_t>(count, (got - 1) / header.recordLength) : 0;
+    aheadFirst = block.first + chunkRecords;
+    return block;
+}
+
+// Returns a pointer to the raw data of record # record inside the mapping,
+// or NULL if the file is not mapped or the record lies outside of it.
+// The pointer stays valid until the DBFActor is closed or reopened.
+
+const char *DBFActor::mappedRecord(uint32_t record) {
+    if ((map == NULL) || (record >= header.numRecords))
+        return NULL;
+
+    uint64_t pos = header.posFirstRecord + 1 + ((uint64_t) record * header.recordLength);
+
+    if (pos + header.recordLength > mapSize)
+        return NULL;
+
+    return map + pos;
 }
 
 DBFRecord DBFActor::getRecord() {
@@ -175,12 +816,142 @@ DBFRecord DBFActor::operator[](uint32_t record) {
     return getRecord(record);
 }
 
+// Returns a view of the next record. When the file is mapped the view points
+// straight into the mapping, otherwise into the block buffer, which is only
+// refilled once all of its records have been handed out. Returns an invalid
+// view on failure.
+
+DBFRecordView DBFActor::getRecordView() {
+    DBFRecordView rec = nextRecordView();
+
+    while (skipDeleted && rec.deleted())
+        rec = nextRecordView();
+
+    return rec;
+}
+
+DBFRecordView DBFActor::nextRecordView() {
+    if (status.error != STATUS_READY)
+        return DBFRecordView();
+
+    if (map != NULL) {
+        const char *rec = mappedRecord(cursor);
+        if (rec == NULL) {
+            DO_FAIL(STATUS_FAILED_TO_READ);
+            if (throwErrors)
+                throw status;
+            return DBFRecordView();
+        }
+        cursor++;
+        return DBFRecordView(&fields, rec, header.recordLength);
+    }
+
+    if ((cursor < current.first) || (cursor - current.first >= current.count)) {
+        current = fillBlock(cursor, UINT32_MAX);
+        if (current.count == 0) {
+            if (status.error == STATUS_READY)
+                DO_FAIL(STATUS_FAILED_TO_READ);
+            if (throwErrors)
+                throw status;
+            return DBFRecordView();
+        }
+    }
+
+    cursor++;
+    return current.record(cursor - 1 - current.first);
+}
+
+// Random access only reads the one record, unless it is already in the
+// current block, so lookups don't pay for a whole block read.
+
+DBFRecordView DBFActor::getRecordView(uint32_t record) {
+    seekRecord(record);
+
+    if ((map == NULL) && (status.error == STATUS_READY) &&
+            ((cursor < current.first) || (cursor - current.first >= current.count)))
+        current = fillBlock(cursor, 1);
+
+    return nextRecordView();
+}
+
+// Has the sequential getRecordView() pass over records marked deleted.
+// Records read by number and blocks are unaffected; check
+// DBFRecordView::deleted() and DBFBlock::deleted() instead.
+
+void DBFActor::setSkipDeleted(bool skip) {
+    skipDeleted = skip;
+}
+
+// Writes the records not marked deleted, in order, to a new dbf fileName
+// with the same header and fields, a block at a time. The header is first
+// written with no records and rewritten once at the end, after the end of
+// file marker, with the record count and today's date. Memo fields keep
+// their block numbers, so the memo file has to be copied along with the
+// new dbf. Leaves the cursor past the last record.
+
+void DBFActor::pack(string fileName) {
+    reset();
+
+    if (status.error != STATUS_READY)
+        return;
+
+    DBFHeader packed = header;
+    packed.numRecords = 0;
+
+    ofstream out(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+    out.write((const char *) &packed, sizeof (DBFHeader));
+    out.write(headerData.data(), headerData.size());
+
+    RecordVec live;
+    live.reserve(blockSize + header.recordLength);
+
+    for (DBFBlock block = readBlock(); block.count > 0; block = readBlock()) {
+        for (uint32_t i = 0; i < block.count; i++) {
+            if (block.deleted(i))
+                continue;
+            const char *rec = block.data + (size_t) i * header.recordLength - 1;
+            live.insert(live.end(), rec, rec + header.recordLength);
+            packed.numRecords++;
+        }
+
+        out.write(live.data(), live.size());
+        live.clear();
+    }
+
+    if (status.error != STATUS_READY)
+        return;
+
+    const char eof = 0x1A;
+    out.write(&eof, 1);
+
+    stampToday(packed);
+    out.seekp(0);
+    out.write((const char *) &packed, sizeof (DBFHeader));
+    out.close();
+
+    if (out.fail()) {
+        DO_FAIL(STATUS_FAILED_TO_WRITE);
+        if (throwErrors)
+            throw status;
+    }
+}
+
 // Returns the number of records in the dbf
 
 uint32_t DBFActor::length() {
     return header.numRecords;
 }
 
+DBFHeader DBFActor::getHeader() {
+    return header;
+}
+
+// Returns the counts of the reads done since the file was opened
+
+DBFIOStats DBFActor::getIOStats() {
+    return ioStats;
+}
+
 // Returns the status of the DBFActor. This is the same data that gets
 // thrown if throwErrors == true
 
@@ -192,13 +963,39 @@ DBFStatus DBFActor::getStatus() {
 
 void DBFActor::close() {
     setStatus(STATUS_CLOSED, 0, "");
-    file.close();
+    unmap();
+    stopAhead();
+    memo.close();
+    appendBuffer.clear();
+    appended = 0;
+    appendWritten = 0;
+    streamFd = -1;
+    inflater.reset();
+    if (file.is_open())
+        file.close();
 }
 
-void DBFActor::writeRawRecord(char *buf) {
+void DBFActor::writeRawRecord(const char *buf) {
     if (status.error != STATUS_READY)
         return;
 
+    // Mappings are read only and streams can't go back to write
+    if ((map != NULL) || isStream()) {
+        DO_FAIL(STATUS_FAILED_TO_WRITE);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    // Blocks already read ahead may be missing the write
+    stopAhead();
+
+    if (fileRecord != cursor) {
+        seekRecord(cursor);
+        if (status.error != STATUS_READY)
+            return;
+    }
+
     file.write(buf, header.recordLength);
 
     if (file.fail()) {
@@ -207,17 +1004,129 @@ void DBFActor::writeRawRecord(char *buf) {
             throw status;
         return;
     }
+
+    cursor++;
+    fileRecord++;
+    current.count = 0;
 }
 
-void DBFActor::writeRecord(DBFRecord record) {
+void DBFActor::writeRecord(const DBFRecord &record) {
     writeRawRecord(record.record.data());
 }
 
-void DBFActor::writeRecord(uint32_t recnum, DBFRecord record) {
+void DBFActor::writeRecord(uint32_t recnum, const DBFRecord &record) {
     seekRecord(recnum);
     writeRecord(record);
 }
 
+// Adds a record after the last one. buf holds the record the way
+// readRawRecord() returns it, of which the last byte, the deletion flag of
+// the following record, is ignored. Records are collected and written a
+// block at a time, and only become part of the dbf, counted in the header,
+// once commitAppend() is called.
+
+void DBFActor::appendRawRecord(const char *buf) {
+    if (status.error != STATUS_READY)
+        return;
+
+    if ((map != NULL) || isStream()) {
+        DO_FAIL(STATUS_FAILED_TO_WRITE);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    if (header.recordLength == 0)
+        return;
+
+    appendBuffer.push_back(' ');
+    appendBuffer.insert(appendBuffer.end(), buf, buf + header.recordLength - 1);
+    appended++;
+
+    if (appendBuffer.size() >= blockSize)
+        flushAppends();
+}
+
+void DBFActor::appendRecord(const DBFRecord &record) {
+    appendRawRecord(record.record.data());
+}
+
+// Writes the records appended so far, then the end of file marker after
+// them and the header with the new record count and today's date. Until
+// then the header still describes the dbf as it was, so readers never see
+// a partly appended batch.
+
+void DBFActor::commitAppend() {
+    if (status.error != STATUS_READY)
+        return;
+
+    flushAppends();
+
+    if ((status.error != STATUS_READY) || (appended == 0))
+        return;
+
+    // The header only takes the new count once the file has it
+    DBFHeader updated = header;
+    updated.numRecords += appended;
+    stampToday(updated);
+
+    const char eof = 0x1A;
+
+    file.clear();
+    file.seekp(updated.posFirstRecord + ((uint64_t) updated.numRecords * updated.recordLength));
+    file.write(&eof, 1);
+    file.seekp(0);
+    file.write((const char *) &updated, sizeof (DBFHeader));
+    file.flush();
+
+    if (file.fail()) {
+        DO_FAIL(STATUS_FAILED_TO_WRITE);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    header = updated;
+    appended = 0;
+    appendWritten = 0;
+}
+
+// Returns the number of records appended since the last commitAppend()
+
+uint32_t DBFActor::pendingAppends() {
+    return appended;
+}
+
+// Writes out the buffered appended records with a single write, each
+// starting on the deletion flag of its record, the first one overwriting
+// the current end of file marker.
+
+void DBFActor::flushAppends() {
+    if (appendBuffer.empty())
+        return;
+
+    uint64_t pos = header.posFirstRecord + ((uint64_t) (header.numRecords + appendWritten) * header.recordLength);
+
+    stopAhead();
+    file.clear();
+    file.seekp(pos);
+    file.write(appendBuffer.data(), appendBuffer.size());
+
+    // The stream is somewhere past the records now
+    fileRecord = UINT32_MAX;
+    current.count = 0;
+
+    if (file.fail()) {
+        DO_FAIL(STATUS_FAILED_TO_WRITE);
+        if (throwErrors)
+            throw status;
+        return;
+    }
+
+    appendWritten += appendBuffer.size() / header.recordLength;
+    appendBuffer.clear();
+}
+
 // Returns the field record for field fieldName or returns
 // an empty field with number 0 if not in a ready state
 
@@ -226,8 +1135,7 @@ DBFField DBFActor::getField(string fieldName) {
         return fields[fieldName];
     }
 
-    DBFField nullField;
-    nullField.fieldNumber = 0;
+    DBFField nullField = {};
     return nullField;
 }
 
@@ -237,17 +1145,49 @@ DBFField DBFActor::getField(string fieldName) {
 // or if the DBFActor is not in the ready state
 
 DBFField DBFActor::getField(uint16_t fieldNumber) {
-    if (status.error == STATUS_READY) {
-        for (auto f : fields) {
-            if (f.second.fieldNumber == fieldNumber)
-                return f.second;
-        }
+    if ((status.error == STATUS_READY) && (fieldNumber >= 1) && (fieldNumber <= fieldList.size()))
+        return fieldList[fieldNumber - 1];
+
+    DBFField nullField = {};
+    return nullField;
+}
+
+// Returns all fields ordered by field number
 
+const vector<DBFField> &DBFActor::getFields() {
+    return fieldList;
+}
+
+// Looks fieldName up ignoring case, the way dbftool's options name fields.
+// Returns false if there is no such field.
+
+bool DBFActor::findField(string fieldName, DBFField &field) {
+    transform(fieldName.begin(), fieldName.end(), fieldName.begin(), ::toupper);
+
+    for (const DBFField &f : fieldList) {
+        string name = f.fieldInfo.name;
+        transform(name.begin(), name.end(), name.begin(), ::toupper);
+        if (name == fieldName) {
+            field = f;
+            return true;
+        }
     }
 
-    DBFField nullField;
-    nullField.fieldNumber = 0;
-    return nullField;
+    return false;
+}
+
+// Returns the text of memo field field of rec, or an empty view if the
+// record has no memo or the memo file couldn't be opened. The view points
+// into the memo file mapping and stays valid until the DBFActor is closed
+// or reopened.
+
+string_view DBFActor::getMemo(const DBFRecordView &rec, const DBFField &field) {
+    uint32_t block;
+
+    if (!fieldMemoBlock(field, rec.get(field), block))
+        return string_view();
+
+    return memo.get(block);
 }
 
 uint16_t DBFActor::getFieldCount() {
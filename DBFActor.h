@@ -33,9 +33,12 @@
 
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <stdint.h>
+#include "MemoFile.h"
 
 struct __attribute__((__packed__)) DBFHeader {
     uint8_t fileType; // DBF Type
@@ -64,6 +67,17 @@ struct DBFField {
     uint16_t fieldNumber; // The position of the field in the header/record data
 };
 
+struct DBFDate {
+    int year;
+    int month; // 1 to 12
+    int day; // 1 to 31
+};
+
+struct DBFDateTime {
+    DBFDate date;
+    uint32_t millis; // Milliseconds since midnight
+};
+
 struct DBFStatus {
     int error; // Error number as defined vy STATUS_ constants
     int syserror; // Last system error
@@ -71,6 +85,15 @@ struct DBFStatus {
     std::string srcFile; // Source file the error happened in
 };
 
+// Counts of the reads a DBFActor has done since it was opened. Bytes handed
+// out of a mapping count as read, but no read calls are made for them.
+
+struct DBFIOStats {
+    uint64_t headerNanos; // Time spent reading and parsing the header
+    uint64_t bytesRead; // Bytes read from the file or stream, or out of the mapping
+    uint64_t readCalls; // Reads issued to the file, stream or decompressor
+};
+
 typedef std::map<std::string, DBFField> FieldMap;
 typedef std::vector<char> RecordVec;
 
@@ -94,7 +117,7 @@ private:
     RecordVec record;
     FieldMap fields;
 public:
-    DBFRecord(FieldMap fmap, RecordVec rvec);
+    DBFRecord(const FieldMap &fmap, const RecordVec &rvec);
     DBFRecord(const DBFRecord& orig);
     std::string operator()(std::string fieldName);
     FieldProxy operator[](std::string fieldName);
@@ -102,6 +125,51 @@ public:
     void set(std::string fieldName, std::string value);
 };
 
+// A non-owning view of a single record. The view points at the schema owned
+// by the DBFActor that produced it and at raw record data that is either in
+// the file mapping or in the actor's read buffer, so it is only valid until
+// the next read from, or close of, that actor. The record's deletion flag is
+// always the byte before its data.
+
+class DBFRecordView {
+private:
+    const FieldMap *fields; // Schema of the dbf the record came from
+    const char *data; // Raw record data, not owned
+    uint16_t length; // Length of the raw record data
+public:
+    DBFRecordView();
+    DBFRecordView(const FieldMap *fmap, const char *data, uint16_t length);
+    std::string_view operator()(const std::string &fieldName) const;
+    std::string_view get(const std::string &fieldName) const;
+    std::string_view get(const DBFField &field) const;
+    std::string_view raw() const;
+    bool getInt64(const DBFField &field, int64_t &out) const;
+    bool getDouble(const DBFField &field, double &out) const;
+    bool getDate(const DBFField &field, DBFDate &out) const;
+    bool getDateTime(const DBFField &field, DBFDateTime &out) const;
+    bool getBool(const DBFField &field, bool &out) const;
+    bool valid() const;
+    bool deleted() const;
+    DBFRecord toRecord() const;
+};
+
+// A run of consecutive records read with a single I/O call. When the file is
+// mapped the data points into the mapping, otherwise into the actor's block
+// buffer, which is reused by the next read.
+
+struct DBFBlock {
+    const FieldMap *fields; // Schema of the dbf the records came from
+    const char *data; // Raw data of the first record in the block
+    uint32_t first; // Record number of the first record in the block
+    uint32_t count; // Number of records in the block
+    uint16_t recordLength; // Distance between records in data
+    DBFRecordView record(uint32_t index) const;
+    bool deleted(uint32_t index) const;
+};
+
+class Decompressor;
+class ReadAhead;
+
 class DBFActor {
 public:
     static const int STATUS_CLOSED = -1;
@@ -110,37 +178,102 @@ public:
     static const int STATUS_FAILED_TO_READ = 2;
     static const int STATUS_FAILED_TO_SEEK = 3;
     static const int STATUS_FAILED_TO_WRITE = 4;
+    static const int STATUS_NO_DECOMPRESSOR = 5;
+    static const size_t DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
 private:
     std::fstream file; // File Stream
+    char *map; // Read only mapping of the whole file when opened with openMapped
+    uint64_t mapSize; // Size of the mapping in bytes
+    int streamFd; // Descriptor read forward only when opened with openStream, or -1
+    uint64_t streamPos; // Bytes read from the stream so far
+    bool streamEnd; // True once a read from the stream has come up short
+    char streamLast; // Last byte read from the stream
+    std::unique_ptr<Decompressor> inflater; // Source of the stream for gzip and zstd files
+    std::unique_ptr<ReadAhead> ahead; // Reads blocks on other threads when setReadAhead() is on
+    unsigned aheadDepth; // Block reads kept in flight ahead of readBlock(), or 0
+    uint32_t aheadFirst; // Record the next block from ahead starts at
+    std::string path; // Name of the file opened with open()
+    MemoFile memo; // The .dbt or .fpt file holding the text of memo fields
+    uint32_t cursor; // Next record to be read or written
+    uint32_t fileRecord; // Record the stream is positioned at
     DBFHeader header; // DBF file header information
     FieldMap fields; // Holds information on the field structure
+    std::vector<DBFField> fieldList; // The same fields in record order
+    RecordVec blockBuffer; // Backs blocks and record views when the file is not mapped
+    size_t blockSize; // Size in bytes of block reads
+    DBFBlock current; // Block the sequential getRecordView() is working through
+    RecordVec appendBuffer; // Appended records not yet written, with their deletion flags
+    uint32_t appended; // Records appended since the last commitAppend()
+    uint32_t appendWritten; // How many of those have been written to the file
     DBFStatus status; // Holds status and error information
+    DBFIOStats ioStats; // Reads done since the file was opened
     bool throwErrors; // Throw errors if true
     uint16_t fieldCount; // Number of fields in file
+    RecordVec headerData; // Raw field descriptors and anything else up to the first record
+    bool skipDeleted; // Sequential getRecordView() passes over deleted records if true
+    bool schemaReused; // True if the last open kept the fields of the file before
     static const unsigned char HEADER_RECORD_TERMINATOR = 0x0d;
+    static const size_t HEADER_READ_SIZE = 4096;
 public:
     DBFActor(std::string fileName, bool throwErrors);
     DBFActor(std::string fileName);
     DBFActor(bool throwErrors);
     DBFActor();
+    ~DBFActor();
     void open(std::string fileName);
+    void openMapped(std::string fileName);
+    void openStream(int fd);
+    bool isMapped();
+    bool isStream();
     void close();
     void reset();
     void seekRecord(uint32_t record);
     void readRawRecord(char *buf);
+    const char *mappedRecord(uint32_t record);
+    DBFBlock readBlock();
+    void setBlockSize(size_t bytes);
+    void setReadAhead(unsigned reads);
     DBFRecord getRecord();
     DBFRecord getRecord(uint32_t record);
     DBFRecord operator[](uint32_t record);
+    DBFRecordView getRecordView();
+    DBFRecordView getRecordView(uint32_t record);
+    void setSkipDeleted(bool skip);
+    void pack(std::string fileName);
     uint32_t length();
+    DBFHeader getHeader();
     DBFStatus getStatus();
-    void writeRawRecord(char *buf);
-    void writeRecord(DBFRecord record);
-    void writeRecord(uint32_t recnum, DBFRecord record);
+    DBFIOStats getIOStats();
+    void writeRawRecord(const char *buf);
+    void writeRecord(const DBFRecord &record);
+    void writeRecord(uint32_t recnum, const DBFRecord &record);
+    void appendRawRecord(const char *buf);
+    void appendRecord(const DBFRecord &record);
+    void commitAppend();
+    uint32_t pendingAppends();
     DBFField getField(std::string fieldName);
     DBFField getField(uint16_t fieldNumber);
+    const std::vector<DBFField> &getFields();
+    bool findField(std::string fieldName, DBFField &field);
+    std::string_view getMemo(const DBFRecordView &rec, const DBFField &field);
     uint16_t getFieldCount();
+    bool sameSchema();
+    const RecordVec &getDescriptors();
 private:
     void setStatus(int error, int line, const char *file);
+    void countRead(uint64_t bytes);
+    bool parseFields(const char *buf, uint64_t size);
+    bool loadFields(RecordVec &descriptors);
+    DBFBlock fillBlock(uint32_t first, uint32_t limit);
+    DBFBlock aheadBlock(DBFBlock block, uint64_t pos, uint32_t count);
+    void stopAhead();
+    DBFRecordView nextRecordView();
+    void unmap();
+    void readStreamHeader();
+    void openMemo(const std::string &fileName);
+    size_t streamRead(char *buf, size_t len);
+    bool streamSkip(uint64_t pos);
+    void flushAppends();
 };
 
 std::ostream& operator<<(std::ostream &out, const DBFRecord::FieldProxy &fp);
@@ -0,0 +1,334 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   DBFApi.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 20, 2026, 2:10 PM
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <vector>
+#include <strings.h>
+#include "DBFActor.h"
+#include "DBFApi.h"
+#include "FieldDecode.h"
+
+using namespace std;
+
+struct dbf_file {
+    DBFActor dbf; // The open dbf
+    vector<DBFField> fields; // Its fields, in record order
+    uint32_t records; // Number of records from the header
+    uint16_t recordLength; // Length of a record, deletion flag included
+    size_t blockSize; // Bytes dbf reads at a time, sized to the last dbf_read
+};
+
+static string_view trimSpaces(string_view v) {
+    size_t first = v.find_first_not_of(' ');
+    if (first == string_view::npos)
+        return string_view();
+    return v.substr(first, v.find_last_not_of(' ') - first + 1);
+}
+
+// Returns field index of file, or NULL if there isn't one or it doesn't fit
+// in the records
+
+static const DBFField *columnField(const dbf_file *file, uint16_t index) {
+    if ((file == NULL) || (index >= file->fields.size()))
+        return NULL;
+
+    const DBFField &field = file->fields[index];
+    if (1 + field.fieldOffset + field.fieldInfo.length > file->recordLength)
+        return NULL;
+    return &field;
+}
+
+// Decodes field index of count records into values with decode, a
+// function of the field, its raw data and the value to set
+
+template <typename T, typename Decode>
+static int64_t decodeColumn(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        T *values, uint8_t *valid, Decode decode) {
+    const DBFField *field = columnField(file, index);
+
+    if ((field == NULL) || (count && ((records == NULL) || (values == NULL))))
+        return DBF_ERROR_ARGUMENT;
+
+    const char *data = (const char *) records + 1 + field->fieldOffset;
+    int64_t found = 0;
+
+    for (uint32_t i = 0; i < count; i++, data += file->recordLength) {
+        T value = T();
+        bool ok = decode(*field, string_view(data, field->fieldInfo.length), value);
+
+        values[i] = ok ? value : T();
+        if (valid)
+            valid[i] = ok;
+        if (ok)
+            found++;
+    }
+
+    return found;
+}
+
+int dbf_api_version(void) {
+    return DBF_API_VERSION;
+}
+
+// Opens the dbf at path, and its memo file if it has one
+
+int dbf_open(const char *path, int flags, dbf_file **out) {
+    if ((path == NULL) || (out == NULL))
+        return DBF_ERROR_ARGUMENT;
+    *out = NULL;
+
+    try {
+        unique_ptr<dbf_file> file(new dbf_file());
+
+        if (flags & DBF_OPEN_MAPPED)
+            file->dbf.openMapped(path);
+        else file->dbf.open(path);
+
+        if (file->dbf.getStatus().error != DBFActor::STATUS_READY)
+            return DBF_ERROR_OPEN;
+
+        file->fields = file->dbf.getFields();
+        file->records = file->dbf.length();
+        file->recordLength = file->dbf.getHeader().recordLength;
+        file->blockSize = DBFActor::DEFAULT_BLOCK_SIZE;
+        *out = file.release();
+        return DBF_OK;
+    } catch (const bad_alloc &) {
+        return DBF_ERROR_MEMORY;
+    } catch (...) {
+        return DBF_ERROR_OPEN;
+    }
+}
+
+void dbf_close(dbf_file *file) {
+    delete file;
+}
+
+uint32_t dbf_record_count(const dbf_file *file) {
+    return file ? file->records : 0;
+}
+
+uint16_t dbf_record_length(const dbf_file *file) {
+    return file ? file->recordLength : 0;
+}
+
+uint16_t dbf_field_count(const dbf_file *file) {
+    return file ? file->fields.size() : 0;
+}
+
+int dbf_field(const dbf_file *file, uint16_t index, dbf_field_info *out) {
+    if ((file == NULL) || (out == NULL) || (index >= file->fields.size()))
+        return DBF_ERROR_ARGUMENT;
+
+    const DBFField &field = file->fields[index];
+
+    memset(out, 0, sizeof (dbf_field_info));
+    memcpy(out->name, field.fieldInfo.name, sizeof (field.fieldInfo.name));
+    out->type = field.fieldInfo.type;
+    out->decimals = field.fieldInfo.decimalCount;
+    out->length = field.fieldInfo.length;
+    out->offset = field.fieldOffset + 1;
+    out->text_length = max<size_t>(field.fieldInfo.length, normalizedLength(field));
+    return DBF_OK;
+}
+
+// Returns the index of the field called name, ignoring case, or
+// DBF_ERROR_ARGUMENT if there isn't one
+
+int dbf_field_index(const dbf_file *file, const char *name) {
+    if ((file == NULL) || (name == NULL))
+        return DBF_ERROR_ARGUMENT;
+
+    for (size_t i = 0; i < file->fields.size(); i++) {
+        char f[sizeof (DBFFieldInfo::name) + 1] = {0};
+        memcpy(f, file->fields[i].fieldInfo.name, sizeof (DBFFieldInfo::name));
+        if (strcasecmp(f, name) == 0)
+            return i;
+    }
+
+    return DBF_ERROR_ARGUMENT;
+}
+
+int64_t dbf_read(dbf_file *file, uint32_t first, uint32_t count, void *buf, size_t size) {
+    if ((file == NULL) || ((buf == NULL) && (size > 0)))
+        return DBF_ERROR_ARGUMENT;
+
+    uint16_t rl = file->recordLength;
+    if (rl == 0)
+        return 0;
+    if (count > size / rl)
+        count = size / rl;
+    if (count == 0)
+        return 0;
+
+    try {
+        DBFActor &dbf = file->dbf;
+
+        // Read no more than the caller asked for
+        size_t bytes = (size_t) count * rl;
+        if (bytes > DBFActor::DEFAULT_BLOCK_SIZE)
+            bytes = DBFActor::DEFAULT_BLOCK_SIZE;
+        if (bytes != file->blockSize) {
+            dbf.setBlockSize(bytes);
+            file->blockSize = bytes;
+        }
+
+        char *dest = (char *) buf;
+        uint32_t copied = 0;
+
+        dbf.seekRecord(first);
+
+        while (copied < count) {
+            DBFBlock block = dbf.readBlock();
+            if (block.count == 0)
+                break;
+
+            // Blocks start on the deletion flag of their first record
+            uint32_t n = min(block.count, count - copied);
+            memcpy(dest + (size_t) copied * rl, block.data - 1, (size_t) n * rl);
+            copied += n;
+        }
+
+        if (dbf.getStatus().error != DBFActor::STATUS_READY)
+            return DBF_ERROR_READ;
+        return copied;
+    } catch (const bad_alloc &) {
+        return DBF_ERROR_MEMORY;
+    } catch (...) {
+        return DBF_ERROR_READ;
+    }
+}
+
+int64_t dbf_column_deleted(const dbf_file *file, const void *records, uint32_t count, uint8_t *deleted) {
+    if ((file == NULL) || (count && ((records == NULL) || (deleted == NULL))))
+        return DBF_ERROR_ARGUMENT;
+
+    const char *data = (const char *) records;
+    int64_t found = 0;
+
+    for (uint32_t i = 0; i < count; i++, data += file->recordLength) {
+        deleted[i] = (*data == '*');
+        found += deleted[i];
+    }
+
+    return found;
+}
+
+int64_t dbf_column_int64(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        int64_t *values, uint8_t *valid) {
+    return decodeColumn(file, records, count, index, values, valid, fieldInt64);
+}
+
+int64_t dbf_column_double(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        double *values, uint8_t *valid) {
+    return decodeColumn(file, records, count, index, values, valid, fieldDouble);
+}
+
+int64_t dbf_column_bool(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        uint8_t *values, uint8_t *valid) {
+    return decodeColumn(file, records, count, index, values, valid,
+            [](const DBFField &field, string_view raw, uint8_t &out) {
+                bool b;
+                if (!fieldBool(field, raw, b))
+                    return false;
+                out = b;
+                return true;
+            });
+}
+
+int64_t dbf_column_date(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        int32_t *values, uint8_t *valid) {
+    return decodeColumn(file, records, count, index, values, valid,
+            [](const DBFField &field, string_view raw, int32_t &out) {
+                DBFDate date;
+                if (!fieldDate(field, raw, date))
+                    return false;
+                out = daysSinceEpoch(date);
+                return true;
+            });
+}
+
+int64_t dbf_column_timestamp(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        int64_t *values, uint8_t *valid) {
+    return decodeColumn(file, records, count, index, values, valid,
+            [](const DBFField &field, string_view raw, int64_t &out) {
+                DBFDateTime dt;
+                if (!fieldDateTime(field, raw, dt))
+                    return false;
+                out = daysSinceEpoch(dt.date) * 86400000LL + dt.millis;
+                return true;
+            });
+}
+
+int64_t dbf_column_text(dbf_file *file, const void *records, uint32_t count, uint16_t index, int flags,
+        char *text, size_t size, uint32_t *offsets) {
+    const DBFField *field = columnField(file, index);
+
+    if ((field == NULL) || (offsets == NULL) || (count && (records == NULL)) || ((text == NULL) && (size > 0)))
+        return DBF_ERROR_ARGUMENT;
+
+    char buf[NORMALIZE_BUFFER_SIZE];
+    bool memo = fieldIsMemo(*field);
+    size_t used = 0;
+
+    offsets[0] = 0;
+
+    try {
+        for (uint32_t i = 0; i < count; i++) {
+            const char *data = (const char *) records + (size_t) i * file->recordLength + 1;
+            string_view raw(data + field->fieldOffset, field->fieldInfo.length);
+            string_view v;
+
+            if (memo)
+                v = file->dbf.getMemo(DBFRecordView(NULL, data, file->recordLength - 1), *field);
+            else if (flags & DBF_TEXT_NORMALIZE)
+                v = normalizeField(*field, raw, buf);
+            else v = trimSpaces(raw);
+
+            if ((v.length() > size - used) || (used + v.length() > UINT32_MAX))
+                return DBF_ERROR_SPACE;
+
+            if (!v.empty())
+                memcpy(text + used, v.data(), v.length());
+            used += v.length();
+            offsets[i + 1] = used;
+        }
+    } catch (const bad_alloc &) {
+        return DBF_ERROR_MEMORY;
+    } catch (...) {
+        return DBF_ERROR_READ;
+    }
+
+    return used;
+}
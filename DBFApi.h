@@ -0,0 +1,130 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   DBFApi.h
+ * Author: Heath Leach
+ *
+ * Created on October 20, 2026, 2:10 PM
+ */
+
+#ifndef DBFAPI_H
+#define	DBFAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * C interface of libdbftool, for services that bind to it from other
+ * languages instead of running dbftool. Records are read in batches into a
+ * buffer the caller owns, exactly as they are in the file: record_length
+ * bytes each, starting with the deletion flag. The dbf_column_ functions
+ * then decode one field of a whole batch into caller arrays.
+ *
+ * Functions returning int return DBF_OK or a negative DBF_ERROR_ code. No C++
+ * exceptions cross this interface. A dbf_file must only be used by one
+ * thread at a time, but any number can be open at once.
+ *
+ * The layout of dbf_field_info and the behavior of these functions only
+ * change along with DBF_API_VERSION.
+ */
+
+#define DBF_API_VERSION 1
+
+#define DBF_OK 0
+#define DBF_ERROR_OPEN (-1) /* The file couldn't be opened or isn't a dbf */
+#define DBF_ERROR_READ (-2) /* Reading the records failed */
+#define DBF_ERROR_ARGUMENT (-3) /* A NULL pointer or a field out of range */
+#define DBF_ERROR_SPACE (-4) /* The caller's buffer is too small */
+#define DBF_ERROR_MEMORY (-5) /* Out of memory */
+
+#define DBF_OPEN_MAPPED 1 /* Memory map the file instead of reading it */
+
+#define DBF_TEXT_NORMALIZE 1 /* dbf_column_text gives numbers, dates and logicals in dbftool -n form */
+
+typedef struct dbf_file dbf_file;
+
+typedef struct {
+    char name[12]; /* Field name, NUL terminated */
+    char type; /* dbf type letter, such as C, N, D or M */
+    uint8_t decimals; /* Number of decimal places */
+    uint16_t length; /* Length of the field in the record */
+    uint16_t offset; /* Offset of the field from the start of the record */
+    uint16_t text_length; /* Most bytes one non memo value takes in dbf_column_text */
+} dbf_field_info;
+
+int dbf_api_version(void);
+
+int dbf_open(const char *path, int flags, dbf_file **out);
+void dbf_close(dbf_file *file);
+
+uint32_t dbf_record_count(const dbf_file *file);
+uint16_t dbf_record_length(const dbf_file *file);
+uint16_t dbf_field_count(const dbf_file *file);
+int dbf_field(const dbf_file *file, uint16_t index, dbf_field_info *out);
+int dbf_field_index(const dbf_file *file, const char *name);
+
+/* Copies up to count records, starting at record first (0 based), into buf
+ * of size bytes. Returns the number copied, which is less than count at the
+ * end of the file or when buf is full, or a negative error. */
+int64_t dbf_read(dbf_file *file, uint32_t first, uint32_t count, void *buf, size_t size);
+
+/* Sets deleted[i] to 1 for each of count records read by dbf_read that is
+ * marked deleted, otherwise 0. Returns the number of deleted records, or a
+ * negative error. */
+int64_t dbf_column_deleted(const dbf_file *file, const void *records, uint32_t count, uint8_t *deleted);
+
+/* Each of these decodes field index of count records read by dbf_read. A
+ * value that is blank, malformed or can't be represented is stored as 0
+ * with valid[i] set to 0, otherwise valid[i] is 1; valid may be NULL. They
+ * return the number of valid values, or a negative error. */
+int64_t dbf_column_int64(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        int64_t *values, uint8_t *valid);
+int64_t dbf_column_double(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        double *values, uint8_t *valid);
+int64_t dbf_column_bool(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        uint8_t *values, uint8_t *valid);
+/* Days since 1970-01-01 */
+int64_t dbf_column_date(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        int32_t *values, uint8_t *valid);
+/* Milliseconds since 1970-01-01 00:00:00 */
+int64_t dbf_column_timestamp(const dbf_file *file, const void *records, uint32_t count, uint16_t index,
+        int64_t *values, uint8_t *valid);
+
+/* Stores the values of field index, trimmed of spaces, one after the other
+ * in text of size bytes, value i running from offsets[i] to offsets[i + 1],
+ * so offsets must hold count + 1 entries. Memo fields give the memo text.
+ * Returns the number of bytes stored, or DBF_ERROR_SPACE if they don't fit,
+ * which count * text_length bytes always do for non memo fields. */
+int64_t dbf_column_text(dbf_file *file, const void *records, uint32_t count, uint16_t index, int flags,
+        char *text, size_t size, uint32_t *offsets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* DBFAPI_H */
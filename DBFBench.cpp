@@ -0,0 +1,292 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   DBFBench.cpp
+ * Author: Heath Leach
+ *
+ * Created on October 18, 2026, 9:40 AM
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "Base94.h"
+#include "DBFActor.h"
+#include "DBFGenerator.h"
+#include "HeapCounter.h"
+
+extern char **environ;
+
+using namespace std;
+
+string fileName = "dbfbench.dbf";
+string toolName = "";
+GeneratorSpec spec = {1000000, 16, 10, "CN9DL", 1};
+uint32_t lookups = 100000;
+string threads = "1";
+bool doMapped = false;
+bool doKeep = false;
+
+void do_help() {
+    cout << "dbfbench - time reads of a synthetic dbf." << endl;
+    cout << endl;
+    cout << "    -r <rows>     : Number of records to generate. Defaults to 1000000." << endl;
+    cout << "    -n <fields>   : Number of fields in each record. Defaults to 16." << endl;
+    cout << "    -w <width>    : Length of character, numeric and base 94 fields. Defaults to 10." << endl;
+    cout << "    -t <types>    : Field types, cycled across the fields. C, N, F, D, L, I, B, Y, T" << endl;
+    cout << "                    and 9 for base 94 digits in a C field. Defaults to CN9DL." << endl;
+    cout << "    -s <seed>     : Seed for the field values. Defaults to 1." << endl;
+    cout << "    -l <lookups>  : Number of random record lookups. Defaults to 100000." << endl;
+    cout << "    -f <file.dbf> : Name of the generated file. Defaults to dbfbench.dbf." << endl;
+    cout << "    -e <dbftool>  : dbftool to time dumps with. Defaults to the one next to dbfbench." << endl;
+    cout << "    -j <threads>  : Threads dbftool formats on. Defaults to 1." << endl;
+    cout << "    -m            : Memory map the file instead of reading it." << endl;
+    cout << "    -k            : Keep the generated file." << endl;
+    cout << endl;
+    exit(1);
+}
+
+void setup(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if ((arg == "-m") || (arg == "-k")) {
+            if (arg == "-m")
+                doMapped = true;
+            else doKeep = true;
+            continue;
+        }
+
+        if (!hasValue)
+            do_help();
+        const char *value = argv[++i];
+
+        if (arg == "-r")
+            spec.rows = strtoul(value, NULL, 10);
+        else if (arg == "-n")
+            spec.fields = strtoul(value, NULL, 10);
+        else if (arg == "-w")
+            spec.width = strtoul(value, NULL, 10);
+        else if (arg == "-t")
+            spec.types = value;
+        else if (arg == "-s")
+            spec.seed = strtoull(value, NULL, 10);
+        else if (arg == "-l")
+            lookups = strtoul(value, NULL, 10);
+        else if (arg == "-f")
+            fileName = value;
+        else if (arg == "-e")
+            toolName = value;
+        else if (arg == "-j")
+            threads = value;
+        else do_help();
+    }
+
+    if (toolName.empty()) {
+        string self = argv[0];
+        size_t slash = self.rfind('/');
+        toolName = (slash == string::npos) ? "dbftool" : self.substr(0, slash + 1) + "dbftool";
+    }
+}
+
+// Prints one line of results for records of recordLength bytes handled in
+// seconds with allocations heap allocations
+
+void report(const char *name, uint64_t records, uint16_t recordLength, double seconds, uint64_t allocations) {
+    double rate = (seconds > 0) ? records / seconds : 0;
+    double mb = (seconds > 0) ? records * (double) recordLength / seconds / (1024 * 1024) : 0;
+    double perRecord = records ? allocations / (double) records : 0;
+    printf("%-22s %12llu %10.3f %14.0f %10.1f %11.4f\n", name, (unsigned long long) records, seconds, rate, mb, perRecord);
+}
+
+// Returns how long work took to run in seconds, and sets allocations to the
+// number of heap allocations it made
+
+double timed(const function<void()> &work, uint64_t &allocations) {
+    uint64_t before = heapAllocations();
+    auto start = chrono::steady_clock::now();
+    work();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    allocations = heapAllocations() - before;
+    return seconds;
+}
+
+void open_dbf(DBFActor &dbf) {
+    if (doMapped)
+        dbf.openMapped(fileName);
+    else dbf.open(fileName);
+
+    if (dbf.getStatus().error != DBFActor::STATUS_READY) {
+        cerr << "Could not open " << fileName << "." << endl;
+        exit(1);
+    }
+}
+
+// Runs dbftool with args on the generated file, its output going to
+// /dev/null, and sets allocations to the heap allocations its --stats
+// reports for the scan. Returns false if it couldn't be run or failed.
+
+bool run_tool(const vector<string> &args, uint64_t &allocations) {
+    string statsName = fileName + ".stats";
+    vector<string> all = {toolName, "-f", fileName, "-j", threads, "--stats=json"};
+    if (doMapped)
+        all.push_back("-m");
+    all.insert(all.end(), args.begin(), args.end());
+
+    vector<char *> argv;
+    for (string &a : all)
+        argv.push_back((char *) a.c_str());
+    argv.push_back(NULL);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, statsName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    pid_t child;
+    int err = posix_spawn(&child, toolName.c_str(), &actions, NULL, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (err != 0)
+        return false;
+
+    int st;
+    bool ok = (waitpid(child, &st, 0) == child) && WIFEXITED(st) && (WEXITSTATUS(st) == 0);
+
+    ifstream statsFile(statsName);
+    string json((istreambuf_iterator<char>(statsFile)), istreambuf_iterator<char>());
+    size_t pos = json.find("\"heap_allocations\":");
+    allocations = (pos == string::npos) ? 0 : strtoull(json.c_str() + pos + 19, NULL, 10);
+    unlink(statsName.c_str());
+
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    setup(argc, argv);
+
+    vector<string> b94Fields;
+    uint64_t allocations;
+    double seconds = timed([&]() {
+        if (!generateDBF(fileName, spec, b94Fields)) {
+            cerr << "Could not generate " << fileName << "." << endl;
+            exit(1);
+        }
+    }, allocations);
+
+    DBFActor dbf;
+    open_dbf(dbf);
+    uint32_t rows = dbf.length();
+    uint16_t recordLength = dbf.getHeader().recordLength;
+
+    printf("%u records of %u fields, %u bytes each\n\n", rows, dbf.getFieldCount(), recordLength);
+    printf("%-22s %12s %10s %14s %10s %11s\n", "test", "records", "seconds", "records/s", "MB/s", "allocs/rec");
+    report("generate", rows, recordLength, seconds, allocations);
+
+    seconds = timed([&]() {
+        for (uint32_t i = 0; i < rows; i++)
+            dbf.getRecord();
+    }, allocations);
+    report("getRecord scan", rows, recordLength, seconds, allocations);
+
+    dbf.reset();
+    seconds = timed([&]() {
+        for (uint32_t i = 0; i < rows; i++)
+            dbf.getRecordView();
+    }, allocations);
+    report("getRecordView scan", rows, recordLength, seconds, allocations);
+
+    if (rows > 0) {
+        mt19937 rng(spec.seed);
+        seconds = timed([&]() {
+            for (uint32_t i = 0; i < lookups; i++)
+                dbf[rng() % rows];
+        }, allocations);
+        report("random operator[]", lookups, recordLength, seconds, allocations);
+    }
+
+    if (!b94Fields.empty()) {
+        vector<DBFField> b94;
+        for (const string &name : b94Fields)
+            b94.push_back(dbf.getField(name));
+
+        vector<uint8_t> hits;
+        vector<uint64_t> values;
+        vector<uint8_t> results;
+
+        dbf.reset();
+        seconds = timed([&]() {
+            DBFBlock block = dbf.readBlock();
+            while (block.count > 0) {
+                hits.assign(block.count, 1);
+                values.resize(block.count);
+                results.resize(block.count);
+                for (const DBFField &f : b94)
+                    decodeBase94Block(block, f.fieldOffset, f.fieldInfo.length, hits,
+                        values.data(), results.data(), 1);
+                block = dbf.readBlock();
+            }
+        }, allocations);
+        report("base 94 decode", rows, recordLength, seconds, allocations);
+    }
+    dbf.close();
+
+    string b94List;
+    for (const string &name : b94Fields)
+        b94List += (b94List.empty() ? "" : ",") + name;
+
+    vector<pair<const char *, vector<string>>> dumps = {
+        {"delim_dump", {}},
+        {"column_dump", {"-c"}},
+        {"delim_dump -n", {"-n"}},
+    };
+    if (!b94List.empty())
+        dumps.push_back({"delim_dump -9", {"-9", b94List}});
+
+    for (auto &d : dumps) {
+        bool ok = true;
+        uint64_t toolAllocations = 0;
+        seconds = timed([&]() {
+            ok = run_tool(d.second, toolAllocations);
+        }, allocations);
+        if (ok)
+            report(d.first, rows, recordLength, seconds, toolAllocations);
+        else printf("%-22s could not run %s\n", d.first, toolName.c_str());
+    }
+
+    if (!doKeep)
+        unlink(fileName.c_str());
+
+    return 0;
+}
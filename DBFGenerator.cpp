@@ -0,0 +1,217 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   DBFGenerator.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 18, 2026, 9:05 AM
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include "DBFActor.h"
+#include "DBFGenerator.h"
+
+using namespace std;
+
+static const uint32_t GENERATOR_BLOCK_RECORDS = 4096;
+static const int64_t JULIAN_2000 = 2451545; // Julian day number of January 1, 2000
+
+// Returns the length of a field of type with the given width, or 0 for an
+// unknown type
+
+static uint8_t fieldLength(char type, uint8_t width) {
+    switch (type) {
+        case 'C':
+        case '9':
+            return max<uint8_t>(width, 1);
+        case 'N':
+        case 'F':
+            return min<uint8_t>(max<uint8_t>(width, 4), 18);
+        case 'D':
+        case 'B':
+        case 'Y':
+        case 'T':
+            return 8;
+        case 'I':
+            return 4;
+        case 'L':
+            return 1;
+    }
+    return 0;
+}
+
+static void putLE32(char *p, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+        p[i] = (char) (v >> (i * 8));
+}
+
+static void putLE64(char *p, uint64_t v) {
+    for (int i = 0; i < 8; i++)
+        p[i] = (char) (v >> (i * 8));
+}
+
+// Fills length bytes at p with a random value of type
+
+static void fillField(char *p, char type, uint8_t length, mt19937_64 &rng) {
+    uint64_t r = rng();
+    char buf[32];
+
+    switch (type) {
+        case 'C':
+        {
+            uint8_t n = 1 + r % length;
+            for (uint8_t i = 0; i < n; i++, r = (r >> 5) | (r << 59))
+                p[i] = 'A' + (r & 31) % 26;
+            memset(p + n, ' ', length - n);
+            break;
+        }
+        case '9':
+        {
+            // Base 94 values are left aligned, up to 10 digits so that both
+            // the 64 bit fast path and the general path get exercised
+            uint8_t n = 1 + r % min<uint8_t>(length, 10);
+            for (uint8_t i = 0; i < n; i++)
+                p[i] = '!' + rng() % 94;
+            memset(p + n, ' ', length - n);
+            break;
+        }
+        case 'N':
+        case 'F':
+        {
+            // fieldLength() keeps N and F fields to 18 bytes, so digits is
+            // always length - 3 and the value fits in buf
+            int digits = min(length - 3, 15);
+            uint64_t scale = 1;
+            for (int i = 0; i < digits; i++)
+                scale *= 10;
+            snprintf(buf, sizeof (buf), "%*llu.%02u", digits,
+                    (unsigned long long) ((r >> 8) % scale), (unsigned) (r & 0xff) % 100);
+            memcpy(p, buf, length);
+            break;
+        }
+        case 'D':
+            snprintf(buf, sizeof (buf), "%04u%02u%02u", 1950 + (unsigned) (r % 80),
+                    1 + (unsigned) ((r >> 8) % 12), 1 + (unsigned) ((r >> 16) % 28));
+            memcpy(p, buf, 8);
+            break;
+        case 'L':
+            p[0] = (r & 1) ? 'T' : 'F';
+            break;
+        case 'I':
+            putLE32(p, (uint32_t) r);
+            break;
+        case 'B':
+        {
+            double d = (double) (int64_t) (r >> 11) / 1000.0;
+            memcpy(p, &d, 8);
+            break;
+        }
+        case 'Y':
+            putLE64(p, r >> 16);
+            break;
+        case 'T':
+            putLE32(p, (uint32_t) (JULIAN_2000 - 10000 + (int64_t) (r % 20000)));
+            putLE32(p + 4, (uint32_t) ((r >> 32) % 86400000));
+            break;
+    }
+}
+
+bool generateDBF(const string &fileName, const GeneratorSpec &spec, vector<string> &b94Fields) {
+    if (spec.types.empty() || (spec.fields == 0))
+        return false;
+
+    vector<DBFFieldInfo> infos(spec.fields);
+    vector<char> types(spec.fields);
+    uint32_t recordLength = 1;
+
+    b94Fields.clear();
+    for (uint16_t i = 0; i < spec.fields; i++) {
+        char type = spec.types[i % spec.types.size()];
+        uint8_t length = fieldLength(type, spec.width);
+        if (length == 0)
+            return false;
+
+        DBFFieldInfo &info = infos[i];
+        memset(&info, 0, sizeof (info));
+        snprintf(info.name, sizeof (info.name), "%c%u", (type == '9') ? 'K' : type, i + 1);
+        info.type = (type == '9') ? 'C' : type;
+        info.fieldDisplacement = recordLength;
+        info.length = length;
+        info.decimalCount = ((type == 'N') || (type == 'F')) ? 2 : 0;
+
+        if (type == '9')
+            b94Fields.push_back(info.name);
+        types[i] = type;
+        recordLength += length;
+    }
+
+    if (recordLength > UINT16_MAX)
+        return false;
+
+    DBFHeader header;
+    memset(&header, 0, sizeof (header));
+    time_t now = time(NULL);
+    struct tm today;
+    localtime_r(&now, &today);
+    header.fileType = 0x03;
+    header.lastUpdated[0] = today.tm_year;
+    header.lastUpdated[1] = today.tm_mon + 1;
+    header.lastUpdated[2] = today.tm_mday;
+    header.numRecords = spec.rows;
+    header.posFirstRecord = sizeof (DBFHeader) + spec.fields * sizeof (DBFFieldInfo) + 1;
+    header.recordLength = recordLength;
+
+    ofstream out(fileName, ios::binary | ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    out.write((const char *) &header, sizeof (header));
+    out.write((const char *) infos.data(), infos.size() * sizeof (DBFFieldInfo));
+    out.put(0x0d);
+
+    mt19937_64 rng(spec.seed);
+    vector<char> block((size_t) GENERATOR_BLOCK_RECORDS * recordLength);
+
+    for (uint32_t done = 0; done < spec.rows;) {
+        uint32_t count = min(GENERATOR_BLOCK_RECORDS, spec.rows - done);
+        char *rec = block.data();
+
+        for (uint32_t r = 0; r < count; r++, rec += recordLength) {
+            rec[0] = ' ';
+            for (uint16_t i = 0; i < spec.fields; i++)
+                fillField(rec + infos[i].fieldDisplacement, types[i], infos[i].length, rng);
+        }
+        out.write(block.data(), (size_t) count * recordLength);
+        done += count;
+    }
+
+    out.put(0x1a);
+    out.close();
+    return !out.fail();
+}
@@ -0,0 +1,60 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   DBFGenerator.h
+ * Author: Heath Leach
+ *
+ * Created on October 18, 2026, 9:05 AM
+ */
+
+#ifndef DBFGENERATOR_H
+#define	DBFGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// Describes a synthetic dbf for benchmarking. Field i has the type
+// types[i % types.size()], so "CN9" gives a character, a numeric and a
+// base 94 field, repeated until there are fields of them. Type letters are
+// the dbf types C, N, F, D, L, I, B, Y and T, plus 9 for a character field
+// holding base 94 digits. Character and base 94 fields are width bytes
+// long, numeric fields width bytes with 2 decimals, up to 18 bytes.
+
+struct GeneratorSpec {
+    uint32_t rows; // Number of records to write
+    uint16_t fields; // Number of fields in each record
+    uint8_t width; // Length of character, base 94 and numeric fields
+    std::string types; // Field type letters, cycled across the fields
+    uint64_t seed; // Seed for the field values, the same seed gives the same file
+};
+
+// Writes the dbf described by spec to fileName and puts the names of its
+// base 94 fields in b94Fields. Returns false if the spec has an unknown
+// type or the file couldn't be written.
+
+bool generateDBF(const std::string &fileName, const GeneratorSpec &spec,
+        std::vector<std::string> &b94Fields);
+
+#endif	/* DBFGENERATOR_H */
@@ -0,0 +1,308 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   DBFIndex.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 16, 2026, 4:40 PM
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <sys/stat.h>
+#include "DBFIndex.h"
+
+using namespace std;
+
+const char DBFIndex::INDEX_MAGIC[8] = {'D', 'B', 'F', 'T', 'I', 'D', 'X', '1'};
+
+DBFIndex::DBFIndex() {
+    memset(&header, 0, sizeof (DBFIndexHeader));
+}
+
+// Returns the name of the index file on fieldName for the dbf dbfName
+
+string DBFIndex::fileName(string dbfName, string fieldName) {
+    transform(fieldName.begin(), fieldName.end(), fieldName.begin(), ::toupper);
+    return dbfName + "." + fieldName + ".idx";
+}
+
+// Scans every record of dbf and writes a new index on fieldName next to
+// dbfName. The dbf is reset to its first record afterwards.
+
+bool DBFIndex::build(DBFActor &dbf, string dbfName, string fieldName) {
+    DBFIndexHeader h;
+
+    if (!describe(dbf, dbfName, fieldName, h))
+        return false;
+
+    DBFField field;
+    dbf.findField(fieldName, field);
+
+    size_t width = h.keyLength + sizeof (uint32_t);
+    vector<char> raw;
+    raw.reserve((size_t) h.numRecords * width);
+
+    dbf.reset();
+    DBFBlock block = dbf.readBlock();
+
+    while (block.count > 0) {
+        for (uint32_t i = 0; i < block.count; i++) {
+            string_view v = block.record(i).get(field);
+            size_t first = v.find_first_not_of(' ');
+            if (first == string_view::npos)
+                v = string_view();
+            else v = v.substr(first, v.find_last_not_of(' ') - first + 1);
+
+            size_t at = raw.size();
+            raw.resize(at + width, '\0');
+            memcpy(raw.data() + at, v.data(), v.length());
+
+            uint32_t recno = block.first + i;
+            memcpy(raw.data() + at + h.keyLength, &recno, sizeof (uint32_t));
+        }
+        block = dbf.readBlock();
+    }
+
+    if (dbf.getStatus().error != DBFActor::STATUS_READY) {
+        error = "could not read " + dbfName;
+        return false;
+    }
+
+    dbf.reset();
+
+    // Records were added in order, so a stable sort on the key alone keeps
+    // equal keys in record order
+    uint32_t count = raw.size() / width;
+    vector<uint32_t> order(count);
+    iota(order.begin(), order.end(), 0);
+
+    size_t keyLength = h.keyLength;
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return memcmp(raw.data() + (a * width), raw.data() + (b * width), keyLength) < 0;
+    });
+
+    vector<char> sorted(raw.size());
+    for (uint32_t i = 0; i < count; i++)
+        memcpy(sorted.data() + (i * width), raw.data() + ((size_t) order[i] * width), width);
+
+    h.entries = count;
+    h.checksum = checksum(h, sorted);
+
+    string name = fileName(dbfName, fieldName);
+    string tmpName = name + ".tmp";
+    ofstream out(tmpName.c_str(), ios::out | ios::binary | ios::trunc);
+    out.write((const char *) &h, sizeof (DBFIndexHeader));
+    out.write(sorted.data(), sorted.size());
+    out.close();
+
+    if (out.fail() || (rename(tmpName.c_str(), name.c_str()) != 0)) {
+        error = "could not write " + name;
+        remove(tmpName.c_str());
+        return false;
+    }
+
+    header = h;
+    entries.swap(sorted);
+    return true;
+}
+
+// Loads the index on fieldName of dbfName. Fails if there is no index, if
+// the dbf has changed since it was built or if it is damaged.
+
+bool DBFIndex::open(DBFActor &dbf, string dbfName, string fieldName) {
+    DBFIndexHeader expect;
+    DBFIndexHeader h;
+
+    entries.clear();
+
+    if (!describe(dbf, dbfName, fieldName, expect))
+        return false;
+
+    string name = fileName(dbfName, fieldName);
+    ifstream in(name.c_str(), ios::in | ios::binary);
+    in.read((char *) &h, sizeof (DBFIndexHeader));
+
+    if (in.fail()) {
+        error = "no index " + name;
+        return false;
+    }
+
+    if (memcmp(&h, &expect, offsetof(DBFIndexHeader, entries)) != 0) {
+        error = "index " + name + " is out of date";
+        return false;
+    }
+
+    vector<char> data((size_t) h.entries * (h.keyLength + sizeof (uint32_t)));
+    in.read(data.data(), data.size());
+
+    if (in.fail() || (in.peek() != char_traits<char>::eof()) || (checksum(h, data) != h.checksum)) {
+        error = "index " + name + " is damaged";
+        return false;
+    }
+
+    header = h;
+    entries.swap(data);
+    return true;
+}
+
+// Returns the record numbers, in ascending order, whose trimmed field value
+// equals key
+
+vector<uint32_t> DBFIndex::find(string_view key) {
+    if (key.length() > header.keyLength)
+        return vector<uint32_t>();
+
+    string k = this->key(key, '\0');
+    return collect(lowerBound(k), upperBound(k));
+}
+
+// Returns the record numbers, in ascending order, whose trimmed field value
+// starts with prefix
+
+vector<uint32_t> DBFIndex::findPrefix(string_view prefix) {
+    if (prefix.length() > header.keyLength)
+        return vector<uint32_t>();
+
+    return collect(lowerBound(key(prefix, '\0')), upperBound(key(prefix, '\xff')));
+}
+
+// Returns the record numbers, in ascending order, whose trimmed field value
+// lies between low and high inclusive
+
+vector<uint32_t> DBFIndex::findRange(string_view low, string_view high) {
+    string lowKey = key(low.substr(0, header.keyLength), '\0');
+    string highKey = key(high.substr(0, header.keyLength), '\0');
+
+    // Keys are never longer than the field, so a key equal to a truncated
+    // low end is still below it
+    uint32_t from = low.length() > header.keyLength ? upperBound(lowKey) : lowerBound(lowKey);
+    uint32_t to = upperBound(highKey);
+
+    return collect(from, to < from ? from : to);
+}
+
+string DBFIndex::getError() {
+    return error;
+}
+
+// Fills h with what an index on fieldName of dbf must record
+
+bool DBFIndex::describe(DBFActor &dbf, string dbfName, string fieldName, DBFIndexHeader &h) {
+    DBFField field;
+    struct stat st;
+
+    if (!dbf.findField(fieldName, field)) {
+        error = "unknown field " + fieldName;
+        return false;
+    }
+
+    if (stat(dbfName.c_str(), &st) != 0) {
+        error = "could not stat " + dbfName;
+        return false;
+    }
+
+    DBFHeader dh = dbf.getHeader();
+
+    memset(&h, 0, sizeof (DBFIndexHeader));
+    memcpy(h.magic, INDEX_MAGIC, sizeof (h.magic));
+    memcpy(h.lastUpdated, dh.lastUpdated, sizeof (h.lastUpdated));
+    h.numRecords = dh.numRecords;
+    h.posFirstRecord = dh.posFirstRecord;
+    h.recordLength = dh.recordLength;
+    h.fileSize = st.st_size;
+    h.fileModified = st.st_mtime;
+    memcpy(h.fieldName, field.fieldInfo.name, sizeof (h.fieldName));
+    h.fieldOffset = field.fieldOffset;
+    h.keyLength = field.fieldInfo.length;
+
+    return true;
+}
+
+string DBFIndex::key(string_view value, char pad) {
+    string k(value);
+    k.resize(header.keyLength, pad);
+    return k;
+}
+
+uint32_t DBFIndex::lowerBound(const string &k) {
+    size_t width = header.keyLength + sizeof (uint32_t);
+    uint32_t lo = 0;
+    uint32_t hi = header.entries;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (memcmp(entries.data() + ((size_t) mid * width), k.data(), header.keyLength) < 0)
+            lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+uint32_t DBFIndex::upperBound(const string &k) {
+    size_t width = header.keyLength + sizeof (uint32_t);
+    uint32_t lo = 0;
+    uint32_t hi = header.entries;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (memcmp(entries.data() + ((size_t) mid * width), k.data(), header.keyLength) <= 0)
+            lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+vector<uint32_t> DBFIndex::collect(uint32_t from, uint32_t to) {
+    size_t width = header.keyLength + sizeof (uint32_t);
+    vector<uint32_t> records;
+
+    for (uint32_t i = from; i < to; i++) {
+        uint32_t recno;
+        memcpy(&recno, entries.data() + ((size_t) i * width) + header.keyLength, sizeof (uint32_t));
+        records.push_back(recno);
+    }
+
+    sort(records.begin(), records.end());
+    return records;
+}
+
+uint32_t DBFIndex::checksum(const DBFIndexHeader &h, const vector<char> &entries) {
+    uint32_t hash = 2166136261u;
+    const unsigned char *p = (const unsigned char *) &h;
+
+    for (size_t i = 0; i < offsetof(DBFIndexHeader, checksum); i++)
+        hash = (hash ^ p[i]) * 16777619u;
+
+    for (char c : entries)
+        hash = (hash ^ (unsigned char) c) * 16777619u;
+
+    return hash;
+}
@@ -0,0 +1,87 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   DBFIndex.h
+ * Author: Heath Leach
+ *
+ * Created on October 16, 2026, 4:40 PM
+ */
+
+#ifndef DBFINDEX_H
+#define	DBFINDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+#include "DBFActor.h"
+
+struct __attribute__((__packed__)) DBFIndexHeader {
+    char magic[8]; // Always INDEX_MAGIC
+    uint8_t lastUpdated[3]; // lastUpdated of the dbf when the index was built
+    uint32_t numRecords; // numRecords of the dbf when the index was built
+    uint16_t posFirstRecord; // posFirstRecord of the dbf when the index was built
+    uint16_t recordLength; // recordLength of the dbf when the index was built
+    int64_t fileSize; // Size of the dbf file when the index was built
+    int64_t fileModified; // Modification time of the dbf when the index was built
+    char fieldName[11]; // Indexed field
+    uint16_t fieldOffset; // Offset of the indexed field into the raw record data
+    uint8_t keyLength; // Length of the indexed field, and of each key
+    uint32_t entries; // Number of entries following the header
+    uint32_t checksum; // FNV-1a of the header up to here and all entries
+};
+
+// A sorted array index on one field of a dbf, kept in a sidecar file next to
+// it. Each entry is the field value, trimmed of spaces and padded with NULs
+// to the field length, followed by the record number, so keys order byte by
+// byte the same way the -w filter compares non numeric fields. The index
+// records the state of the dbf it was built from and refuses to open once
+// the dbf has changed or the index itself does not match its checksum.
+
+class DBFIndex {
+private:
+    DBFIndexHeader header; // Header of the loaded index
+    std::vector<char> entries; // Sorted entries of the loaded index
+    std::string error; // Description of the last error
+public:
+    static const char INDEX_MAGIC[8];
+    DBFIndex();
+    static std::string fileName(std::string dbfName, std::string fieldName);
+    bool build(DBFActor &dbf, std::string dbfName, std::string fieldName);
+    bool open(DBFActor &dbf, std::string dbfName, std::string fieldName);
+    std::vector<uint32_t> find(std::string_view key);
+    std::vector<uint32_t> findPrefix(std::string_view prefix);
+    std::vector<uint32_t> findRange(std::string_view low, std::string_view high);
+    std::string getError();
+private:
+    bool describe(DBFActor &dbf, std::string dbfName, std::string fieldName, DBFIndexHeader &h);
+    std::string key(std::string_view value, char pad);
+    uint32_t lowerBound(const std::string &k);
+    uint32_t upperBound(const std::string &k);
+    std::vector<uint32_t> collect(uint32_t from, uint32_t to);
+    static uint32_t checksum(const DBFIndexHeader &h, const std::vector<char> &entries);
+};
+
+#endif	/* DBFINDEX_H */
+
@@ -29,6 +29,7 @@
  */
 
 #include "DBFActor.h"
+#include "FieldDecode.h"
 
 using namespace std;
 
@@ -52,7 +53,7 @@ string DBFRecord::FieldProxy::get() const {
     return parent->get(name);
 }
 
-DBFRecord::DBFRecord(FieldMap fmap, RecordVec rvec) {
+DBFRecord::DBFRecord(const FieldMap &fmap, const RecordVec &rvec) {
     this->fields = fmap;
     this->record = rvec;
 }
@@ -87,4 +88,101 @@ void DBFRecord::set(string fieldName, string value) {
         else
             record[offset + i] = 0x20;
     }
-}
\ No newline at end of file
+}
+
+DBFRecordView::DBFRecordView() {
+    this->fields = NULL;
+    this->data = NULL;
+    this->length = 0;
+}
+
+DBFRecordView::DBFRecordView(const FieldMap *fmap, const char *data, uint16_t length) {
+    this->fields = fmap;
+    this->data = data;
+    this->length = length;
+}
+
+string_view DBFRecordView::operator()(const string &fieldName) const {
+    return get(fieldName);
+}
+
+// Returns an empty view if the field does not exist in the schema
+
+string_view DBFRecordView::get(const string &fieldName) const {
+    if (fields == NULL)
+        return string_view();
+
+    FieldMap::const_iterator f = fields->find(fieldName);
+    if (f == fields->end())
+        return string_view();
+
+    return get(f->second);
+}
+
+// Returns the field data without a name lookup. The field must come from the
+// same schema as the record.
+
+string_view DBFRecordView::get(const DBFField &field) const {
+    if ((data == NULL) || (field.fieldOffset + field.fieldInfo.length > length))
+        return string_view();
+
+    return string_view(data + field.fieldOffset, field.fieldInfo.length);
+}
+
+string_view DBFRecordView::raw() const {
+    return string_view(data, data == NULL ? 0 : length);
+}
+
+// Typed accessors. These decode the raw field data without allocating and
+// return false if the field is blank, malformed or of another type. See
+// FieldDecode.h for the types each one understands.
+
+bool DBFRecordView::getInt64(const DBFField &field, int64_t &out) const {
+    return fieldInt64(field, get(field), out);
+}
+
+bool DBFRecordView::getDouble(const DBFField &field, double &out) const {
+    return fieldDouble(field, get(field), out);
+}
+
+bool DBFRecordView::getDate(const DBFField &field, DBFDate &out) const {
+    return fieldDate(field, get(field), out);
+}
+
+bool DBFRecordView::getDateTime(const DBFField &field, DBFDateTime &out) const {
+    return fieldDateTime(field, get(field), out);
+}
+
+bool DBFRecordView::getBool(const DBFField &field, bool &out) const {
+    return fieldBool(field, get(field), out);
+}
+
+bool DBFRecordView::valid() const {
+    return data != NULL;
+}
+
+// True if the record is marked deleted
+
+bool DBFRecordView::deleted() const {
+    return (data != NULL) && (data[-1] == '*');
+}
+
+// Copies the viewed record into an owning DBFRecord
+
+DBFRecord DBFRecordView::toRecord() const {
+    RecordVec rvec(data, data + (data == NULL ? 0 : length));
+    return DBFRecord(fields == NULL ? FieldMap() : *fields, rvec);
+}
+
+// Returns a view of record # first + index. The index must be below count.
+
+DBFRecordView DBFBlock::record(uint32_t index) const {
+    return DBFRecordView(fields, data + ((size_t) index * recordLength), recordLength);
+}
+
+// True if record index of the block is marked deleted. Blocks always hold
+// the deletion flag of their first record, so this needs no record view.
+
+bool DBFBlock::deleted(uint32_t index) const {
+    return data[(size_t) index * recordLength - 1] == '*';
+}
@@ -0,0 +1,298 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Decompressor.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 16, 2026, 11:15 PM
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "Decompressor.h"
+
+extern char **environ;
+
+using namespace std;
+
+Decompressor::Decompressor() {
+    format = FORMAT_NONE;
+    gz = NULL;
+    pipeFd = -1;
+    child = -1;
+    reading = QUEUE_CHUNKS;
+    readPos = 0;
+    finished = false;
+    failed = false;
+    stopping = false;
+    noCommand = false;
+}
+
+Decompressor::~Decompressor() {
+    close();
+}
+
+// Returns the FORMAT_ constant matching the magic number fileName starts
+// with, or FORMAT_NONE if it isn't compressed or can't be read
+
+int Decompressor::detect(const string &fileName) {
+    unsigned char magic[4];
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return FORMAT_NONE;
+
+    ssize_t n = ::read(fd, magic, sizeof (magic));
+    ::close(fd);
+
+    return detect((const char *) magic, n > 0 ? n : 0);
+}
+
+// Returns the FORMAT_ constant matching the magic number at the start of
+// the len bytes at data
+
+int Decompressor::detect(const char *data, size_t len) {
+    const unsigned char *magic = (const unsigned char *) data;
+
+    if ((len >= 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b))
+        return FORMAT_GZIP;
+    if ((len >= 4) && (magic[0] == 0x28) && (magic[1] == 0xb5) && (magic[2] == 0x2f) && (magic[3] == 0xfd))
+        return FORMAT_ZSTD;
+    return FORMAT_NONE;
+}
+
+// Opens fileName and starts decompressing it. Returns false if it isn't a
+// gzip or zstd file, or can't be opened.
+
+bool Decompressor::open(const string &fileName) {
+    close();
+    noCommand = false;
+    format = detect(fileName);
+
+    if (format == FORMAT_GZIP) {
+        gz = gzopen(fileName.c_str(), "rb");
+        if (gz == NULL)
+            return false;
+        gzbuffer((gzFile) gz, 256 * 1024);
+    } else if (format == FORMAT_ZSTD) {
+        int fds[2];
+        if (pipe(fds) != 0)
+            return false;
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addclose(&actions, fds[0]);
+        posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+        const char *argv[] = {"zstd", "-dcq", "--", fileName.c_str(), NULL};
+        int err = posix_spawnp(&child, "zstd", &actions, NULL, (char * const *) argv, environ);
+
+        posix_spawn_file_actions_destroy(&actions);
+        ::close(fds[1]);
+
+        if (err != 0) {
+            ::close(fds[0]);
+            child = -1;
+            noCommand = true;
+            errno = err;
+            return false;
+        }
+
+        // Searching PATH leaves errno set from the directories without zstd
+        errno = 0;
+        pipeFd = fds[0];
+    } else return false;
+
+    chunks.assign(QUEUE_CHUNKS, vector<char>(CHUNK_SIZE));
+    lengths.assign(QUEUE_CHUNKS, 0);
+    filled.clear();
+    empty.clear();
+    for (size_t i = 0; i < QUEUE_CHUNKS; i++)
+        empty.push_back(i);
+
+    reading = QUEUE_CHUNKS;
+    readPos = 0;
+    finished = false;
+    failed = false;
+    stopping = false;
+
+    worker = thread(&Decompressor::run, this);
+    return true;
+}
+
+// Copies up to len bytes of decompressed output into buf, waiting for the
+// decompression thread as needed. Returns less than len only at the end of
+// the output, or if decompression failed.
+
+size_t Decompressor::read(char *buf, size_t len) {
+    size_t got = 0;
+
+    while (got < len) {
+        if (reading == QUEUE_CHUNKS) {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&] {
+                return !filled.empty() || finished;
+            });
+            if (filled.empty())
+                break;
+            reading = filled.front();
+            filled.pop_front();
+            readPos = 0;
+        }
+
+        size_t n = min(len - got, lengths[reading] - readPos);
+        memcpy(buf + got, chunks[reading].data() + readPos, n);
+        got += n;
+        readPos += n;
+
+        if (readPos == lengths[reading]) {
+            {
+                lock_guard<mutex> guard(lock);
+                empty.push_back(reading);
+            }
+            changed.notify_all();
+            reading = QUEUE_CHUNKS;
+        }
+    }
+
+    return got;
+}
+
+// True if the output stopped early because the file is corrupt or
+// truncated, or the zstd process failed
+
+bool Decompressor::fail() {
+    lock_guard<mutex> guard(lock);
+    return failed;
+}
+
+// True if the last open failed because the zstd command couldn't be
+// started, as when it isn't in PATH
+
+bool Decompressor::commandMissing() {
+    return noCommand;
+}
+
+// Stops the decompression thread and releases the file. The thread finishes
+// the chunk it is filling first.
+
+void Decompressor::close() {
+    if (worker.joinable()) {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        changed.notify_all();
+        worker.join();
+    }
+
+    if (pipeFd >= 0)
+        ::close(pipeFd);
+    pipeFd = -1;
+
+    if (child > 0) {
+        kill(child, SIGTERM);
+        waitpid(child, NULL, 0);
+    }
+    child = -1;
+
+    if (gz != NULL)
+        gzclose((gzFile) gz);
+    gz = NULL;
+
+    format = FORMAT_NONE;
+}
+
+// Decompression thread. Fills free chunks and queues them for the reader
+// until the output ends or close() is called.
+
+void Decompressor::run() {
+    while (true) {
+        size_t chunk;
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&] {
+                return stopping || !empty.empty();
+            });
+            if (stopping)
+                return;
+            chunk = empty.front();
+            empty.pop_front();
+        }
+
+        size_t len = 0;
+        ssize_t n = 1;
+        while ((len < CHUNK_SIZE) && ((n = fill(chunks[chunk].data() + len, CHUNK_SIZE - len)) > 0))
+            len += n;
+
+        bool error = (n < 0);
+
+        if ((n == 0) && (format == FORMAT_GZIP)) {
+            int err;
+            gzerror((gzFile) gz, &err);
+            error = (err != Z_OK);
+        } else if ((n == 0) && (format == FORMAT_ZSTD)) {
+            int st;
+            error = (waitpid(child, &st, 0) != child) || !WIFEXITED(st) || (WEXITSTATUS(st) != 0);
+            child = -1;
+        }
+
+        {
+            lock_guard<mutex> guard(lock);
+            lengths[chunk] = len;
+            filled.push_back(chunk);
+            if (n <= 0) {
+                finished = true;
+                failed = error;
+            }
+        }
+        changed.notify_all();
+
+        if (n <= 0)
+            return;
+    }
+}
+
+// Reads the next piece of decompressed output. Returns 0 at the end of the
+// output and -1 on an error.
+
+ssize_t Decompressor::fill(char *buf, size_t len) {
+    if (format == FORMAT_GZIP)
+        return gzread((gzFile) gz, buf, len);
+
+    ssize_t n;
+    do {
+        n = ::read(pipeFd, buf, len);
+    } while ((n < 0) && (errno == EINTR));
+
+    return n;
+}
@@ -0,0 +1,90 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   Decompressor.h
+ * Author: Heath Leach
+ *
+ * Created on October 16, 2026, 11:15 PM
+ */
+
+#ifndef DECOMPRESSOR_H
+#define	DECOMPRESSOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+// Decompresses a gzip or zstd file on its own thread, handing the output to
+// the reading thread through a small queue of fixed size chunks, so the two
+// run side by side instead of taking turns. The queue is bounded, so the
+// decompression thread waits once it is QUEUE_CHUNKS ahead of the reader.
+//
+// gzip is inflated with zlib. zstd is decompressed by a zstd process writing
+// into a pipe that the decompression thread drains.
+
+class Decompressor {
+public:
+    static const int FORMAT_NONE = 0;
+    static const int FORMAT_GZIP = 1;
+    static const int FORMAT_ZSTD = 2;
+    static const size_t CHUNK_SIZE = 1024 * 1024;
+    static const size_t QUEUE_CHUNKS = 4;
+private:
+    int format; // FORMAT_ constant of the open file
+    void *gz; // zlib gzFile when format is FORMAT_GZIP
+    int pipeFd; // Output of the zstd process when format is FORMAT_ZSTD
+    pid_t child; // The zstd process, or -1
+    std::thread worker; // Decompression thread
+    std::mutex lock;
+    std::condition_variable changed; // Signalled when a chunk is filled or freed
+    std::vector<std::vector<char>> chunks; // Chunk buffers
+    std::vector<size_t> lengths; // Bytes of output held in each chunk
+    std::deque<size_t> filled; // Chunks waiting for the reader, in order
+    std::deque<size_t> empty; // Chunks waiting for the decompression thread
+    size_t reading; // Chunk the reader is working through, or QUEUE_CHUNKS
+    size_t readPos; // Position of the reader in that chunk
+    bool finished; // True once the decompression thread has no more output
+    bool failed; // True if decompression stopped on an error
+    bool stopping; // Tells the decompression thread to give up
+    bool noCommand; // The zstd command couldn't be started
+public:
+    Decompressor();
+    ~Decompressor();
+    static int detect(const std::string &fileName);
+    static int detect(const char *data, size_t len);
+    bool open(const std::string &fileName);
+    size_t read(char *buf, size_t len);
+    bool fail();
+    bool commandMissing();
+    void close();
+private:
+    void run();
+    ssize_t fill(char *buf, size_t len);
+};
+
+#endif	/* DECOMPRESSOR_H */
@@ -0,0 +1,477 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   FieldDecode.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 17, 2026, 8:35 AM
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "FieldDecode.h"
+
+using namespace std;
+
+// An ASCII decimal split into its parts, as found in N and F fields
+
+struct Decimal {
+    bool negative;
+    string_view whole; // Digits before the point
+    string_view fraction; // Digits after the point
+};
+
+static const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+
+static string_view trimBlank(string_view v) {
+    size_t first = v.find_first_not_of(string_view(" \0", 2));
+    if (first == string_view::npos)
+        return string_view();
+    return v.substr(first, v.find_last_not_of(string_view(" \0", 2)) - first + 1);
+}
+
+static bool splitDecimal(string_view text, Decimal &d) {
+    text = trimBlank(text);
+    d.negative = false;
+
+    if (!text.empty() && ((text[0] == '-') || (text[0] == '+'))) {
+        d.negative = text[0] == '-';
+        text.remove_prefix(1);
+    }
+
+    size_t point = text.find('.');
+    d.whole = text.substr(0, point);
+    d.fraction = point == string_view::npos ? string_view() : text.substr(point + 1);
+
+    if (d.whole.empty() && d.fraction.empty())
+        return false;
+
+    for (char c : d.whole)
+        if ((c < '0') || (c > '9'))
+            return false;
+
+    for (char c : d.fraction)
+        if ((c < '0') || (c > '9'))
+            return false;
+
+    return true;
+}
+
+static uint32_t le32(const char *p) {
+    const unsigned char *u = (const unsigned char *) p;
+    return u[0] | (u[1] << 8) | (u[2] << 16) | ((uint32_t) u[3] << 24);
+}
+
+static uint64_t le64(const char *p) {
+    return le32(p) | ((uint64_t) le32(p + 4) << 32);
+}
+
+static char fieldType(const DBFField &field) {
+    return toupper((unsigned char) field.fieldInfo.type);
+}
+
+// Converts a julian day number to a calendar date (Fliegel and Van Flandern)
+
+static void julianToDate(int64_t jd, DBFDate &out) {
+    int64_t l = jd + 68569;
+    int64_t n = (4 * l) / 146097;
+    l = l - (146097 * n + 3) / 4;
+    int64_t i = (4000 * (l + 1)) / 1461001;
+    l = l - (1461 * i) / 4 + 31;
+    int64_t j = (80 * l) / 2447;
+    out.day = l - (2447 * j) / 80;
+    l = j / 11;
+    out.month = j + 2 - (12 * l);
+    out.year = 100 * (n - 49) + i + l;
+}
+
+// Parses a plain decimal number with optional sign and surrounding spaces.
+// Returns false for blank or malformed text.
+
+bool decodeNumber(string_view text, double &out) {
+    Decimal d;
+
+    if (!splitDecimal(text, d))
+        return false;
+
+    double value;
+
+    if (d.whole.length() + d.fraction.length() <= 18) {
+        // Exact while the digits fit in an integer
+        uint64_t mantissa = 0;
+        for (char c : d.whole)
+            mantissa = mantissa * 10 + (c - '0');
+        for (char c : d.fraction)
+            mantissa = mantissa * 10 + (c - '0');
+        value = mantissa / POW10[d.fraction.length()];
+    } else {
+        value = 0;
+        for (char c : d.whole)
+            value = value * 10 + (c - '0');
+        double scale = 1;
+        for (char c : d.fraction) {
+            scale /= 10;
+            value += (c - '0') * scale;
+        }
+    }
+
+    out = d.negative ? -value : value;
+    return true;
+}
+
+// True for the types fieldDouble() can decode
+
+bool fieldIsNumeric(const DBFField &field) {
+    switch (fieldType(field)) {
+        case 'N':
+        case 'F':
+            return true;
+        case 'I':
+            return field.fieldInfo.length == 4;
+        case 'B':
+        case 'Y':
+            return field.fieldInfo.length == 8;
+    }
+    return false;
+}
+
+// Decodes whole numbers. N and F values with a non zero fraction, and B
+// values that aren't integral, are rejected.
+
+bool fieldInt64(const DBFField &field, string_view raw, int64_t &out) {
+    switch (fieldType(field)) {
+        case 'N':
+        case 'F':
+        {
+            Decimal d;
+            if (!splitDecimal(raw, d) || (d.whole.length() > 18))
+                return false;
+            for (char c : d.fraction)
+                if (c != '0')
+                    return false;
+            int64_t value = 0;
+            for (char c : d.whole)
+                value = value * 10 + (c - '0');
+            out = d.negative ? -value : value;
+            return true;
+        }
+        case 'I':
+            if (raw.length() != 4)
+                return false;
+            out = (int32_t) le32(raw.data());
+            return true;
+        case 'Y':
+        {
+            if (raw.length() != 8)
+                return false;
+            int64_t value = (int64_t) le64(raw.data());
+            if (value % 10000 != 0)
+                return false;
+            out = value / 10000;
+            return true;
+        }
+        case 'B':
+        {
+            double value;
+            if (!fieldDouble(field, raw, value) || (value != (double) (int64_t) value))
+                return false;
+            out = (int64_t) value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool fieldDouble(const DBFField &field, string_view raw, double &out) {
+    switch (fieldType(field)) {
+        case 'N':
+        case 'F':
+            return decodeNumber(raw, out);
+        case 'I':
+            if (raw.length() != 4)
+                return false;
+            out = (int32_t) le32(raw.data());
+            return true;
+        case 'Y':
+            if (raw.length() != 8)
+                return false;
+            out = ((int64_t) le64(raw.data())) / 10000.0;
+            return true;
+        case 'B':
+        {
+            if (raw.length() != 8)
+                return false;
+            uint64_t bits = le64(raw.data());
+            memcpy(&out, &bits, sizeof (double));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool fieldDate(const DBFField &field, string_view raw, DBFDate &out) {
+    if (fieldType(field) == 'T') {
+        DBFDateTime dt;
+        if (!fieldDateTime(field, raw, dt))
+            return false;
+        out = dt.date;
+        return true;
+    }
+
+    if ((fieldType(field) != 'D') || (raw.length() != 8))
+        return false;
+
+    int digits[8];
+    for (int i = 0; i < 8; i++) {
+        if ((raw[i] < '0') || (raw[i] > '9'))
+            return false;
+        digits[i] = raw[i] - '0';
+    }
+
+    out.year = digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+    out.month = digits[4] * 10 + digits[5];
+    out.day = digits[6] * 10 + digits[7];
+
+    return (out.month >= 1) && (out.month <= 12) && (out.day >= 1) && (out.day <= 31);
+}
+
+bool fieldDateTime(const DBFField &field, string_view raw, DBFDateTime &out) {
+    if (fieldType(field) == 'D') {
+        out.millis = 0;
+        return fieldDate(field, raw, out.date);
+    }
+
+    if ((fieldType(field) != 'T') || (raw.length() != 8))
+        return false;
+
+    uint32_t day = le32(raw.data());
+    out.millis = le32(raw.data() + 4);
+
+    if ((day == 0) || (out.millis >= 86400000))
+        return false;
+
+    julianToDate(day, out.date);
+    return true;
+}
+
+bool fieldBool(const DBFField &field, string_view raw, bool &out) {
+    if ((fieldType(field) != 'L') || raw.empty())
+        return false;
+
+    switch (raw[0]) {
+        case 'T':
+        case 't':
+        case 'Y':
+        case 'y':
+            out = true;
+            return true;
+        case 'F':
+        case 'f':
+        case 'N':
+        case 'n':
+            out = false;
+            return true;
+    }
+    return false;
+}
+
+// Returns the value of the field in a normalized form: numbers without
+// padding, leading zeros or plus signs, dates as YYYY-MM-DD, date times as
+// YYYY-MM-DD HH:MM:SS and logicals as true or false. Blank and unknown values
+// come back empty, other types trimmed. The result either points into raw or
+// into buf, which must hold NORMALIZE_BUFFER_SIZE bytes.
+
+string_view normalizeField(const DBFField &field, string_view raw, char *buf) {
+    switch (fieldType(field)) {
+        case 'N':
+        case 'F':
+        {
+            Decimal d;
+            if (!splitDecimal(raw, d))
+                return trimBlank(raw);
+
+            size_t zeros = d.whole.find_first_not_of('0');
+            string_view whole = zeros == string_view::npos ? string_view("0") : d.whole.substr(zeros);
+            bool zero = (whole == "0") && (d.fraction.find_first_not_of('0') == string_view::npos);
+
+            size_t len = 0;
+            if (d.negative && !zero)
+                buf[len++] = '-';
+            memcpy(buf + len, whole.data(), whole.length());
+            len += whole.length();
+            if (!d.fraction.empty()) {
+                buf[len++] = '.';
+                memcpy(buf + len, d.fraction.data(), d.fraction.length());
+                len += d.fraction.length();
+            }
+            return string_view(buf, len);
+        }
+        case 'I':
+        {
+            int64_t value;
+            if (!fieldInt64(field, raw, value))
+                break;
+            return string_view(buf, snprintf(buf, NORMALIZE_BUFFER_SIZE, "%lld", (long long) value));
+        }
+        case 'Y':
+        {
+            if (raw.length() != 8)
+                break;
+            int64_t value = (int64_t) le64(raw.data());
+            uint64_t magnitude = value < 0 ? -(uint64_t) value : value;
+            return string_view(buf, snprintf(buf, NORMALIZE_BUFFER_SIZE, "%s%llu.%04llu",
+                    value < 0 ? "-" : "", (unsigned long long) (magnitude / 10000),
+                    (unsigned long long) (magnitude % 10000)));
+        }
+        case 'B':
+        {
+            double value;
+            if (!fieldDouble(field, raw, value))
+                break;
+            // Shortest of 15 or 17 significant digits that reads back exactly
+            int len = snprintf(buf, NORMALIZE_BUFFER_SIZE, "%.15g", value);
+            if (strtod(buf, NULL) != value)
+                len = snprintf(buf, NORMALIZE_BUFFER_SIZE, "%.17g", value);
+            return string_view(buf, len);
+        }
+        case 'D':
+        {
+            DBFDate date;
+            if (!fieldDate(field, raw, date))
+                return trimBlank(raw);
+            return string_view(buf, snprintf(buf, NORMALIZE_BUFFER_SIZE, "%04d-%02d-%02d",
+                    date.year, date.month, date.day));
+        }
+        case 'T':
+        {
+            DBFDateTime dt;
+            if (!fieldDateTime(field, raw, dt))
+                return string_view();
+            uint32_t seconds = dt.millis / 1000;
+            return string_view(buf, snprintf(buf, NORMALIZE_BUFFER_SIZE, "%04d-%02d-%02d %02u:%02u:%02u",
+                    dt.date.year, dt.date.month, dt.date.day,
+                    seconds / 3600, (seconds / 60) % 60, seconds % 60));
+        }
+        case 'L':
+        {
+            bool value;
+            if (!fieldBool(field, raw, value))
+                return string_view();
+            return value ? string_view("true") : string_view("false");
+        }
+    }
+
+    size_t first = raw.find_first_not_of(' ');
+    if (first == string_view::npos)
+        return string_view();
+    return raw.substr(first, raw.find_last_not_of(' ') - first + 1);
+}
+
+// Returns the longest value normalizeField() can return for field
+
+size_t normalizedLength(const DBFField &field) {
+    switch (fieldType(field)) {
+        case 'N':
+        case 'F':
+            // A bare fraction gains a leading zero
+            return field.fieldInfo.length + 1;
+        case 'I':
+            return 11;
+        case 'Y':
+            return 21;
+        case 'B':
+            return 24;
+        case 'D':
+            return 10;
+        case 'T':
+            return 19;
+        case 'L':
+            return 5;
+    }
+    return field.fieldInfo.length;
+}
+
+// True for fields holding a block number in the memo file rather than a
+// value
+
+bool fieldIsMemo(const DBFField &field) {
+    switch (toupper(field.fieldInfo.type)) {
+        case 'M':
+        case 'G':
+        case 'P':
+            return true;
+        case 'B':
+            return field.fieldInfo.length != 8;
+    }
+
+    return false;
+}
+
+// Blank fields and block 0, the memo file header, mean the record has no memo
+
+bool fieldMemoBlock(const DBFField &field, string_view raw, uint32_t &out) {
+    if (!fieldIsMemo(field))
+        return false;
+
+    if (field.fieldInfo.length == 4) {
+        if (raw.size() < 4)
+            return false;
+        out = le32(raw.data());
+        return out != 0;
+    }
+
+    raw = trimBlank(raw);
+    if (raw.empty() || (raw.size() > 10))
+        return false;
+
+    uint64_t block = 0;
+    for (char c : raw) {
+        if ((c < '0') || (c > '9'))
+            return false;
+        block = block * 10 + (c - '0');
+    }
+
+    if ((block == 0) || (block > UINT32_MAX))
+        return false;
+
+    out = block;
+    return true;
+}
+
+// Returns the number of days from 1970-01-01 to date (Hinnant's
+// days_from_civil)
+
+int64_t daysSinceEpoch(const DBFDate &date) {
+    int64_t y = date.year - (date.month <= 2 ? 1 : 0);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (date.month + (date.month > 2 ? -3 : 9)) + 2) / 5 + date.day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
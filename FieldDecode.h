@@ -0,0 +1,69 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   FieldDecode.h
+ * Author: Heath Leach
+ *
+ * Created on October 17, 2026, 8:35 AM
+ */
+
+#ifndef FIELDDECODE_H
+#define	FIELDDECODE_H
+
+#include <string_view>
+#include <stdint.h>
+#include "DBFActor.h"
+
+// Typed decoding of raw field data. None of these allocate; they work on the
+// bytes of the field as found in the record and return false when the field
+// is blank, malformed or of a type that has no such representation.
+//
+//     N, F    ASCII decimal numbers
+//     I       Visual FoxPro 4 byte little endian integer
+//     B       Visual FoxPro 8 byte little endian double (when 8 bytes long)
+//     Y       Visual FoxPro 8 byte little endian currency, scaled by 10000
+//     D       ASCII date, YYYYMMDD
+//     T       Visual FoxPro date time, 4 byte julian day and 4 byte
+//             milliseconds since midnight
+//     L       Logical, one of TtYy or FfNn
+//     M, G, P Memo block number, 10 ASCII digits, or a 4 byte little endian
+//             integer in Visual FoxPro. Also B when not 8 bytes long.
+
+static const size_t NORMALIZE_BUFFER_SIZE = 320;
+
+bool decodeNumber(std::string_view text, double &out);
+bool fieldIsNumeric(const DBFField &field);
+bool fieldInt64(const DBFField &field, std::string_view raw, int64_t &out);
+bool fieldDouble(const DBFField &field, std::string_view raw, double &out);
+bool fieldDate(const DBFField &field, std::string_view raw, DBFDate &out);
+bool fieldDateTime(const DBFField &field, std::string_view raw, DBFDateTime &out);
+bool fieldBool(const DBFField &field, std::string_view raw, bool &out);
+bool fieldIsMemo(const DBFField &field);
+bool fieldMemoBlock(const DBFField &field, std::string_view raw, uint32_t &out);
+std::string_view normalizeField(const DBFField &field, std::string_view raw, char *buf);
+size_t normalizedLength(const DBFField &field);
+int64_t daysSinceEpoch(const DBFDate &date);
+
+#endif	/* FIELDDECODE_H */
+
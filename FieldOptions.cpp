@@ -29,6 +29,7 @@
  */
 
 #include "FieldOptions.h"
+#include <algorithm>
 #include <map>
 #include <sstream>
 
@@ -51,7 +52,9 @@ FieldOptions::FieldOptions(string fields, string fields94, DBFActor &dbf) {
 
 void FieldOptions::open(string fields, string fields94, DBFActor &dbf) {
 
-    for (uint i = 0; i <= dbf.getFieldCount(); i++) {
+    fieldMap.clear();
+
+    for (uint i = 1; i <= dbf.getFieldCount(); i++) {
         string f = dbf.getField(i).fieldInfo.name;
         transform(f.begin(), f.end(), f.begin(), ::toupper);
         fieldMap[f].show = fields == "*" ? true : false;
@@ -93,3 +96,23 @@ bool FieldOptions::wantsB94(string fieldName) {
         return fieldMap[fieldName].b94;
     else return false;
 }
+
+// Resolves the selected fields against the schema of dbf once, in record order
+
+FieldPlan FieldOptions::plan(DBFActor &dbf) {
+    FieldPlan p;
+
+    for (const DBFField &field : dbf.getFields()) {
+        string f = field.fieldInfo.name;
+        transform(f.begin(), f.end(), f.begin(), ::toupper);
+        if (wants(f)) {
+            FieldSelection sel;
+            sel.field = field;
+            sel.name = field.fieldInfo.name;
+            sel.b94 = wantsB94(f);
+            p.push_back(sel);
+        }
+    }
+
+    return p;
+}
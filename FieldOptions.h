@@ -33,6 +33,17 @@
 
 #include "DBFActor.h"
 
+// A selected field resolved against the dbf schema, so the dump loops can
+// slice it out of the raw record without looking it up by name.
+
+struct FieldSelection {
+    DBFField field; // Field information, including its offset into the record
+    std::string name; // Field name as stored in the dbf
+    bool b94; // Decode the field as base 94
+};
+
+typedef std::vector<FieldSelection> FieldPlan;
+
 class FieldOptions {
 public:
     FieldOptions();
@@ -40,6 +51,7 @@ public:
     void open(std::string fields, std::string fields94, DBFActor &dbf);
     bool wants(std::string fieldName);
     bool wantsB94(std::string fieldName);
+    FieldPlan plan(DBFActor &dbf);
 private:
 
 };
@@ -0,0 +1,227 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   FieldScan.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 16, 2026, 3:05 PM
+ */
+
+#include <cstring>
+#include "FieldScan.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+#if defined(__AVX2__)
+static const size_t LANE = 32;
+#elif defined(__SSE2__)
+static const size_t LANE = 16;
+#else
+static const size_t LANE = 1;
+#endif
+
+// Compares n bytes of a with b. Both must be readable for n rounded up to
+// a whole number of lanes.
+
+static bool lanesEqual(const char *a, const char *b, size_t n) {
+#if defined(__AVX2__)
+    for (; n >= LANE; a += LANE, b += LANE, n -= LANE) {
+        __m256i x = _mm256_loadu_si256((const __m256i *) a);
+        __m256i y = _mm256_loadu_si256((const __m256i *) b);
+        if ((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xffffffffu)
+            return false;
+    }
+    if (n == 0)
+        return true;
+    __m256i x = _mm256_loadu_si256((const __m256i *) a);
+    __m256i y = _mm256_loadu_si256((const __m256i *) b);
+    uint32_t mask = (1u << n) - 1;
+    return ((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) & mask) == mask;
+#elif defined(__SSE2__)
+    for (; n >= LANE; a += LANE, b += LANE, n -= LANE) {
+        __m128i x = _mm_loadu_si128((const __m128i *) a);
+        __m128i y = _mm_loadu_si128((const __m128i *) b);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff)
+            return false;
+    }
+    if (n == 0)
+        return true;
+    __m128i x = _mm_loadu_si128((const __m128i *) a);
+    __m128i y = _mm_loadu_si128((const __m128i *) b);
+    int mask = (1 << n) - 1;
+    return (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) & mask) == mask;
+#else
+    return memcmp(a, b, n) == 0;
+#endif
+}
+
+static bool trimmedMatch(const char *f, uint8_t length, string_view value, bool prefix) {
+    string_view v(f, length);
+    size_t first = v.find_first_not_of(' ');
+    if (first == string_view::npos)
+        v = string_view();
+    else v = v.substr(first, v.find_last_not_of(' ') - first + 1);
+
+    if (prefix)
+        return v.substr(0, value.length()) == value;
+    return v == value;
+}
+
+// Sets the hits of the records of block whose first n <= 8 field bytes at
+// offset equal pattern, several records at a time: the field is gathered
+// from each record at recordLength stride into one vector as a 64 bit word
+// and the words are compared with the pattern together. The first bytes are
+// checked for a space in the same way, and only records that miss and start
+// with one are trimmed and compared again. Returns the number of records
+// done, which stops short of those too near the end of the block to read 8
+// bytes from.
+
+static uint32_t wordsEqual(const DBFBlock &block, uint16_t offset, uint8_t length, size_t n,
+        const char *pattern, string_view value, bool prefix, vector<uint8_t> &hits) {
+    const size_t size = (size_t) block.count * block.recordLength;
+    const size_t stride = block.recordLength;
+    const char *f = block.data + offset;
+
+    if (offset + sizeof (uint64_t) > size)
+        return 0;
+
+    uint32_t count = (uint32_t) ((size - offset - sizeof (uint64_t)) / stride + 1);
+    unsigned char bytes[sizeof (uint64_t)] = {0};
+    uint64_t want = 0;
+    uint64_t mask;
+    uint64_t firstMask;
+    uint64_t space;
+
+    memset(bytes, 0xff, n);
+    memcpy(&mask, bytes, sizeof (mask));
+    memset(bytes, 0, sizeof (bytes));
+    bytes[0] = 0xff;
+    memcpy(&firstMask, bytes, sizeof (firstMask));
+    bytes[0] = ' ';
+    memcpy(&space, bytes, sizeof (space));
+    memcpy(&want, pattern, n);
+
+    uint32_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i wantV = _mm256_set1_epi64x((long long) want);
+    const __m256i maskV = _mm256_set1_epi64x((long long) mask);
+    const __m256i firstV = _mm256_set1_epi64x((long long) firstMask);
+    const __m256i spaceV = _mm256_set1_epi64x((long long) space);
+    const __m256i index = _mm256_setr_epi64x(0, stride, 2 * stride, 3 * stride);
+
+    for (; i + 4 <= count; i += 4, f += 4 * stride) {
+        __m256i w = _mm256_i64gather_epi64((const long long *) f, index, 1);
+        int bits = _mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpeq_epi64(_mm256_and_si256(w, maskV), wantV)));
+        int spaces = _mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpeq_epi64(_mm256_and_si256(w, firstV), spaceV)));
+
+        for (int j = 0; j < 4; j++) {
+            if ((spaces & ~bits) & (1 << j))
+                hits[i + j] = trimmedMatch(f + j * stride, length, value, prefix);
+            else hits[i + j] = (bits >> j) & 1;
+        }
+    }
+#elif defined(__SSE2__)
+    // SSE2 has no 64 bit compare, so both 32 bit halves of a word must match
+    const __m128i wantV = _mm_set1_epi64x((long long) want);
+    const __m128i maskV = _mm_set1_epi64x((long long) mask);
+    const __m128i firstV = _mm_set1_epi64x((long long) firstMask);
+    const __m128i spaceV = _mm_set1_epi64x((long long) space);
+
+    for (; i + 2 <= count; i += 2, f += 2 * stride) {
+        uint64_t a;
+        uint64_t b;
+        memcpy(&a, f, sizeof (a));
+        memcpy(&b, f + stride, sizeof (b));
+
+        __m128i w = _mm_set_epi64x((long long) b, (long long) a);
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(w, maskV), wantV)));
+        int spaces = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(w, firstV), spaceV)));
+
+        for (int j = 0; j < 2; j++) {
+            bool hit = ((bits >> (2 * j)) & 0x3) == 0x3;
+            if (!hit && (((spaces >> (2 * j)) & 0x3) == 0x3))
+                hit = trimmedMatch(f + j * stride, length, value, prefix);
+            hits[i + j] = hit;
+        }
+    }
+#endif
+
+    for (; i < count; i++, f += stride) {
+        uint64_t w;
+        memcpy(&w, f, sizeof (w));
+        bool hit = (w & mask) == want;
+        if (!hit && (f[0] == ' '))
+            hit = trimmedMatch(f, length, value, prefix);
+        hits[i] = hit;
+    }
+
+    return count;
+}
+
+void scanFieldEquals(const DBFBlock &block, uint16_t offset, uint8_t length,
+        string_view value, bool prefix, vector<uint8_t> &hits) {
+    hits.assign(block.count, 0);
+
+    if (value.length() > length)
+        return;
+
+    // Equality compares the whole field against value padded with spaces,
+    // a prefix only the bytes of value. If the field does not start with a
+    // space its trimmed value starts at its first byte, so a mismatch there
+    // is final.
+    size_t n = prefix ? value.length() : length;
+    size_t rounded = ((n + LANE - 1) / LANE) * LANE;
+    vector<char> pattern(rounded + LANE, ' ');
+    memcpy(pattern.data(), value.data(), value.length());
+
+    const char *end = block.data + ((size_t) block.count * block.recordLength);
+    uint32_t i = 0;
+
+    if (n <= sizeof (uint64_t))
+        i = wordsEqual(block, offset, length, n, pattern.data(), value, prefix, hits);
+
+    // Wider fields, and the last few records for narrow ones, are compared
+    // a record at a time, a vector of the field at a time
+    const char *f = block.data + offset + (size_t) i * block.recordLength;
+
+    for (; i < block.count; i++, f += block.recordLength) {
+        bool hit;
+
+        if (f + rounded <= end)
+            hit = lanesEqual(f, pattern.data(), n);
+        else hit = memcmp(f, pattern.data(), n) == 0;
+
+        if (!hit && (f[0] == ' '))
+            hit = trimmedMatch(f, length, value, prefix);
+
+        hits[i] = hit;
+    }
+}
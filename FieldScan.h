@@ -0,0 +1,54 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   FieldScan.h
+ * Author: Heath Leach
+ *
+ * Created on October 16, 2026, 3:05 PM
+ */
+
+#ifndef FIELDSCAN_H
+#define	FIELDSCAN_H
+
+#include <string_view>
+#include <vector>
+#include "DBFActor.h"
+
+// Sets hits[i] to 1 for every record i of block whose field at offset, of
+// length bytes, equals value once trimmed of spaces, or starts with value
+// when prefix is true, and to 0 otherwise. The bytes compared are checked
+// against a space padded copy of value. When there are at most 8 of them
+// they are gathered from several records into one SSE2 or AVX2 vector and
+// compared together. Longer fields are compared a record at a time, a
+// vector of the field at a time. Without SSE2 or AVX2 each record is
+// compared with a 64 bit word or memcmp. Only fields with a leading space
+// fall back to trimming and comparing.
+//
+// value must not start or end with a space.
+
+void scanFieldEquals(const DBFBlock &block, uint16_t offset, uint8_t length,
+        std::string_view value, bool prefix, std::vector<uint8_t> &hits);
+
+#endif	/* FIELDSCAN_H */
+
@@ -0,0 +1,177 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   MemoFile.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 17, 2026, 10:20 AM
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MemoFile.h"
+
+using namespace std;
+
+static const uint32_t DBASE_BLOCK_SIZE = 512;
+
+static uint32_t be16(const char *p) {
+    const unsigned char *u = (const unsigned char *) p;
+    return (u[0] << 8) | u[1];
+}
+
+static uint32_t be32(const char *p) {
+    const unsigned char *u = (const unsigned char *) p;
+    return ((uint32_t) u[0] << 24) | (u[1] << 16) | (u[2] << 8) | u[3];
+}
+
+static uint32_t le16(const char *p) {
+    const unsigned char *u = (const unsigned char *) p;
+    return u[0] | (u[1] << 8);
+}
+
+static uint32_t le32(const char *p) {
+    const unsigned char *u = (const unsigned char *) p;
+    return u[0] | (u[1] << 8) | (u[2] << 16) | ((uint32_t) u[3] << 24);
+}
+
+MemoFile::MemoFile() {
+    map = NULL;
+    mapSize = 0;
+    blockSize = DBASE_BLOCK_SIZE;
+    foxPro = false;
+}
+
+MemoFile::~MemoFile() {
+    close();
+}
+
+// Strips the extension off name, if it has one
+
+static string stripExtension(const string &name, string &ext) {
+    size_t dot = name.rfind('.');
+    size_t slash = name.rfind('/');
+
+    if ((dot == string::npos) || ((slash != string::npos) && (dot < slash))) {
+        ext = "";
+        return name;
+    }
+
+    ext = name.substr(dot);
+    return name.substr(0, dot);
+}
+
+// Finds and maps the memo file next to dbfName, the same name with a .fpt
+// or .dbt extension in either case. The memo file of a compressed x.dbf.gz
+// or x.dbf.zst is the uncompressed x.fpt or x.dbt. Returns false if there
+// is none.
+
+bool MemoFile::open(const string &dbfName) {
+    close();
+
+    string ext;
+    string base = stripExtension(dbfName, ext);
+
+    if ((ext == ".gz") || (ext == ".GZ") || (ext == ".zst") || (ext == ".ZST"))
+        base = stripExtension(base, ext);
+
+    const char *extensions[] = {".fpt", ".FPT", ".dbt", ".DBT"};
+    int fd = -1;
+    struct stat st;
+
+    for (const char *ext : extensions) {
+        fd = ::open((base + ext).c_str(), O_RDONLY);
+        if (fd >= 0) {
+            foxPro = (ext[1] == 'f') || (ext[1] == 'F');
+            break;
+        }
+    }
+
+    if ((fd < 0) || (fstat(fd, &st) != 0) || (st.st_size < 512)) {
+        if (fd >= 0)
+            ::close(fd);
+        return false;
+    }
+
+    void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (m == MAP_FAILED)
+        return false;
+
+    map = (char *) m;
+    mapSize = st.st_size;
+
+    // FoxPro allows a block size of 0, meaning 1 byte blocks
+    if (foxPro)
+        blockSize = be16(map + 6) ? be16(map + 6) : 1;
+    else blockSize = le16(map + 20) ? le16(map + 20) : DBASE_BLOCK_SIZE;
+
+    return true;
+}
+
+bool MemoFile::isOpen() const {
+    return map != NULL;
+}
+
+void MemoFile::close() {
+    if (map != NULL)
+        munmap(map, mapSize);
+    map = NULL;
+    mapSize = 0;
+}
+
+// Returns the memo starting at block, or an empty view if there is no such
+// block. Lengths running past the end of the file are cut short.
+
+string_view MemoFile::get(uint32_t block) const {
+    uint64_t pos = (uint64_t) block * blockSize;
+
+    if ((map == NULL) || (block == 0) || (pos >= mapSize))
+        return string_view();
+
+    const char *p = map + pos;
+    uint64_t avail = mapSize - pos;
+
+    if (foxPro) {
+        if (avail < 8)
+            return string_view();
+        return string_view(p + 8, min((uint64_t) be32(p + 4), avail - 8));
+    }
+
+    const unsigned char *u = (const unsigned char *) p;
+    if ((avail >= 8) && (u[0] == 0xFF) && (u[1] == 0xFF) && (u[2] == 0x08) && (u[3] == 0x00)) {
+        uint32_t length = le32(p + 4);
+        if (length < 8)
+            return string_view();
+        return string_view(p + 8, min((uint64_t) length - 8, avail - 8));
+    }
+
+    const char *end = (const char *) memchr(p, 0x1A, avail);
+    return string_view(p, end ? end - p : avail);
+}
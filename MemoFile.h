@@ -0,0 +1,69 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   MemoFile.h
+ * Author: Heath Leach
+ *
+ * Created on October 17, 2026, 10:20 AM
+ */
+
+#ifndef MEMOFILE_H
+#define	MEMOFILE_H
+
+#include <string>
+#include <string_view>
+#include <stdint.h>
+
+// Read only access to the memo file that goes with a dbf: a dBASE III or IV
+// .dbt or a FoxPro .fpt. The file is mapped into memory, so memo text is
+// handed out as views into the mapping and reading a memo column in record
+// order costs page faults the kernel can read ahead for, not a seek and a
+// read per row.
+//
+// A memo starts at a block number held in the memo field of the record.
+//
+//     .fpt          8 byte block header, big endian type and length, then
+//                   the data. Block size is in the file header.
+//     dBASE IV .dbt 8 byte block header, FF FF 08 00 then the little endian
+//                   length including the header. Block size is in the file
+//                   header.
+//     dBASE III .dbt Text running up to a 0x1A end marker in 512 byte
+//                   blocks.
+
+class MemoFile {
+private:
+    char *map; // Mapping of the whole memo file
+    uint64_t mapSize; // Size of the mapping in bytes
+    uint32_t blockSize; // Size of a memo block in bytes
+    bool foxPro; // True for .fpt files
+public:
+    MemoFile();
+    ~MemoFile();
+    bool open(const std::string &dbfName);
+    bool isOpen() const;
+    void close();
+    std::string_view get(uint32_t block) const;
+};
+
+#endif	/* MEMOFILE_H */
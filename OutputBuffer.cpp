@@ -0,0 +1,198 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   OutputBuffer.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 16, 2026, 11:02 AM
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <unistd.h>
+#include "OutputBuffer.h"
+
+using namespace std;
+
+OutputBuffer::OutputBuffer() {
+    fd = -1;
+    limit = DEFAULT_SIZE;
+    failed = false;
+    totalWritten = 0;
+    writeTime = 0;
+}
+
+OutputBuffer::OutputBuffer(int fd) {
+    this->fd = fd;
+    limit = DEFAULT_SIZE;
+    failed = false;
+    totalWritten = 0;
+    writeTime = 0;
+    buf.reserve(limit);
+}
+
+OutputBuffer::OutputBuffer(int fd, size_t size) {
+    this->fd = fd;
+    limit = size;
+    failed = false;
+    totalWritten = 0;
+    writeTime = 0;
+    buf.reserve(limit);
+}
+
+OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+void OutputBuffer::put(char c) {
+    buf.push_back(c);
+}
+
+// Large pieces skip the buffer and go straight to the file descriptor
+
+void OutputBuffer::append(string_view v) {
+    if ((fd >= 0) && (v.size() >= limit)) {
+        flush();
+        writeOut(v.data(), v.size());
+        return;
+    }
+
+    buf.append(v.data(), v.size());
+}
+
+// Appends v left justified in a column of width characters. Values longer
+// than the column are not truncated, the same as setw.
+
+void OutputBuffer::appendPadded(string_view v, size_t width) {
+    buf.append(v.data(), v.size());
+    if (v.size() < width)
+        buf.append(width - v.size(), ' ');
+}
+
+// Digits are produced two at a time from a table of the pairs 00 to 99
+
+void OutputBuffer::appendNumber(unsigned long long n) {
+    static const char PAIRS[] =
+            "00010203040506070809101112131415161718192021222324"
+            "25262728293031323334353637383940414243444546474849"
+            "50515253545556575859606162636465666768697071727374"
+            "75767778798081828384858687888990919293949596979899";
+    char digits[20];
+    int pos = sizeof (digits);
+
+    while (n >= 100) {
+        const char *pair = PAIRS + (n % 100) * 2;
+        n /= 100;
+        digits[--pos] = pair[1];
+        digits[--pos] = pair[0];
+    }
+
+    if (n >= 10) {
+        digits[--pos] = PAIRS[n * 2 + 1];
+        digits[--pos] = PAIRS[n * 2];
+    } else digits[--pos] = '0' + n;
+
+    buf.append(digits + pos, sizeof (digits) - pos);
+}
+
+void OutputBuffer::appendPaddedNumber(unsigned long long n, size_t width) {
+    size_t start = buf.size();
+    appendNumber(n);
+    size_t len = buf.size() - start;
+    if (len < width)
+        buf.append(width - len, ' ');
+}
+
+// Appends v with every quote character doubled
+
+void OutputBuffer::appendEscaped(string_view v, char quote) {
+    size_t pos = 0;
+    size_t found;
+
+    while ((found = v.find(quote, pos)) != string_view::npos) {
+        buf.append(v.data() + pos, found - pos + 1);
+        buf.push_back(quote);
+        pos = found + 1;
+    }
+
+    buf.append(v.data() + pos, v.size() - pos);
+}
+
+// Ends a row and writes the buffer out if it is full. Rows are never split
+// between writes unless a single row is larger than the buffer.
+
+void OutputBuffer::endLine() {
+    buf.push_back('\n');
+    if ((fd >= 0) && (buf.size() >= limit))
+        flush();
+}
+
+void OutputBuffer::flush() {
+    if (fd < 0)
+        return;
+
+    writeOut(buf.data(), buf.size());
+    buf.clear();
+}
+
+// Exchanges the pending output with other. Used to hand a collected chunk
+// off without copying it.
+
+void OutputBuffer::swap(string &other) {
+    buf.swap(other);
+}
+
+bool OutputBuffer::fail() {
+    return failed;
+}
+
+uint64_t OutputBuffer::bytesWritten() {
+    return totalWritten;
+}
+
+uint64_t OutputBuffer::writeNanos() {
+    return writeTime;
+}
+
+void OutputBuffer::writeOut(const char *data, size_t len) {
+    if (len == 0)
+        return;
+
+    auto start = chrono::steady_clock::now();
+
+    while ((len > 0) && !failed) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            failed = true;
+            return;
+        }
+        data += written;
+        len -= written;
+        totalWritten += written;
+    }
+
+    writeTime += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,75 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   OutputBuffer.h
+ * Author: Heath Leach
+ *
+ * Created on October 16, 2026, 11:02 AM
+ */
+
+#ifndef OUTPUTBUFFER_H
+#define	OUTPUTBUFFER_H
+
+#include <string>
+#include <string_view>
+#include <stdint.h>
+
+// Collects output in a large reusable buffer and hands it to a file
+// descriptor with write(2) once it fills up, instead of going through
+// iostreams. Without a file descriptor it only collects, which is what the
+// parallel dump workers use to format their chunks.
+
+class OutputBuffer {
+public:
+    static const size_t DEFAULT_SIZE = 1024 * 1024;
+private:
+    std::string buf; // Pending output
+    int fd; // Destination, or -1 to only collect
+    size_t limit; // Flush once the pending output reaches this size
+    bool failed; // True once a write to fd has failed
+    uint64_t totalWritten; // Bytes written to fd
+    uint64_t writeTime; // Nanoseconds spent in write(2)
+public:
+    OutputBuffer();
+    OutputBuffer(int fd);
+    OutputBuffer(int fd, size_t size);
+    ~OutputBuffer();
+    void put(char c);
+    void append(std::string_view v);
+    void appendPadded(std::string_view v, size_t width);
+    void appendNumber(unsigned long long n);
+    void appendPaddedNumber(unsigned long long n, size_t width);
+    void appendEscaped(std::string_view v, char quote);
+    void endLine();
+    void flush();
+    void swap(std::string &other);
+    bool fail();
+    uint64_t bytesWritten();
+    uint64_t writeNanos();
+private:
+    void writeOut(const char *data, size_t len);
+};
+
+#endif	/* OUTPUTBUFFER_H */
+
@@ -0,0 +1,123 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ParallelScan.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 16, 2026, 9:12 AM
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ParallelScan.h"
+
+using namespace std;
+
+// Splits each of several files, fileRecords[i] records long, into chunks of
+// chunkRecords records and has threads workers format all of them, while the
+// calling thread hands the results to write in order, file by file. Workers
+// take whichever chunk is next from any file as soon as they are free, so a
+// large file is spread over every worker instead of holding up the files
+// behind it. They only run a few chunks ahead of the writer so memory use
+// stays bounded by the chunk size.
+
+void parallelScan(const vector<uint32_t> &fileRecords, uint32_t chunkRecords, unsigned threads,
+        FileChunkFormatter format, ChunkWriter write) {
+    if (threads == 0)
+        threads = 1;
+    if (chunkRecords == 0)
+        chunkRecords = 1;
+
+    vector<ScanChunk> chunkList;
+    for (unsigned file = 0; file < fileRecords.size(); file++) {
+        for (uint32_t first = 0; first < fileRecords[file];) {
+            ScanChunk chunk = {file, first, min(chunkRecords, fileRecords[file] - first)};
+            chunkList.push_back(chunk);
+            first += chunk.count;
+        }
+    }
+
+    size_t chunks = chunkList.size();
+    size_t window = threads * 2;
+
+    vector<string> slots(window);
+    vector<bool> done(window, false);
+    size_t nextChunk = 0;
+    size_t nextWrite = 0;
+    mutex lock;
+    condition_variable changed;
+
+    auto worker = [&](unsigned number) {
+        string out;
+
+        while (true) {
+            size_t chunk;
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&] {
+                    return (nextChunk >= chunks) || (nextChunk < nextWrite + window);
+                });
+                if (nextChunk >= chunks)
+                    return;
+                chunk = nextChunk++;
+            }
+
+            out.clear();
+            format(number, chunkList[chunk], out);
+
+            {
+                lock_guard<mutex> guard(lock);
+                slots[chunk % window].swap(out);
+                done[chunk % window] = true;
+            }
+            changed.notify_all();
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 0; i < threads; i++)
+        pool.push_back(thread(worker, i));
+
+    string out;
+
+    while (nextWrite < chunks) {
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&] {
+                return (bool) done[nextWrite % window];
+            });
+            out.swap(slots[nextWrite % window]);
+            done[nextWrite % window] = false;
+            nextWrite++;
+        }
+        changed.notify_all();
+        write(out);
+    }
+
+    for (thread &t : pool)
+        t.join();
+}
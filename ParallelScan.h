@@ -0,0 +1,58 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ParallelScan.h
+ * Author: Heath Leach
+ *
+ * Created on October 16, 2026, 9:12 AM
+ */
+
+#ifndef PARALLELSCAN_H
+#define	PARALLELSCAN_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// A run of records of one of the files being scanned
+struct ScanChunk {
+    unsigned file; // Index of the file in the list given to parallelScan
+    uint32_t first; // First record of the chunk
+    uint32_t count; // Number of records in the chunk
+};
+
+// Formats the records of chunk into out. worker is the number of the
+// calling thread, from 0 to threads - 1, so callers can keep per thread
+// state such as their own DBFActor.
+typedef std::function<void(unsigned worker, const ScanChunk &chunk, std::string &out)> FileChunkFormatter;
+
+// Receives the formatted chunks in record order
+typedef std::function<void(const std::string &out)> ChunkWriter;
+
+void parallelScan(const std::vector<uint32_t> &fileRecords, uint32_t chunkRecords, unsigned threads,
+        FileChunkFormatter format, ChunkWriter write);
+
+#endif	/* PARALLELSCAN_H */
+
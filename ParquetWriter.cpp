@@ -0,0 +1,374 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ParquetWriter.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 17, 2026, 10:50 AM
+ */
+
+#include <cstring>
+#include "ParquetWriter.h"
+
+using namespace std;
+
+// Parquet physical types, converted types and enums from parquet.thrift
+static const int32_t TYPE_BOOLEAN = 0;
+static const int32_t TYPE_INT32 = 1;
+static const int32_t TYPE_INT64 = 2;
+static const int32_t TYPE_DOUBLE = 5;
+static const int32_t TYPE_BYTE_ARRAY = 6;
+static const int32_t CONVERTED_UTF8 = 0;
+static const int32_t CONVERTED_DATE = 6;
+static const int32_t CONVERTED_TIMESTAMP_MILLIS = 9;
+static const int32_t REPETITION_OPTIONAL = 1;
+static const int32_t ENCODING_PLAIN = 0;
+static const int32_t ENCODING_RLE = 3;
+static const int32_t PAGE_DATA = 0;
+static const int32_t CODEC_UNCOMPRESSED = 0;
+
+static const char MAGIC[] = "PAR1";
+
+// Minimal Thrift compact protocol encoder, enough for the Parquet metadata
+
+class ThriftCompact {
+public:
+    static const uint8_t T_I32 = 5;
+    static const uint8_t T_I64 = 6;
+    static const uint8_t T_BINARY = 8;
+    static const uint8_t T_LIST = 9;
+    static const uint8_t T_STRUCT = 12;
+
+    string buf; // Encoded output
+private:
+    vector<int16_t> lastField; // Last field id written in each open struct
+public:
+
+    ThriftCompact() {
+        lastField.push_back(0);
+    }
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            buf.push_back((char) ((v & 0x7f) | 0x80));
+            v >>= 7;
+        }
+        buf.push_back((char) v);
+    }
+
+    void field(int16_t id, uint8_t type) {
+        int16_t delta = id - lastField.back();
+        if ((delta > 0) && (delta <= 15))
+            buf.push_back((char) ((delta << 4) | type));
+        else {
+            buf.push_back((char) type);
+            varint((uint16_t) ((id << 1) ^ (id >> 15)));
+        }
+        lastField.back() = id;
+    }
+
+    void i32(int16_t id, int32_t v) {
+        field(id, T_I32);
+        varint(((uint32_t) v << 1) ^ (uint32_t) (v >> 31));
+    }
+
+    void i64(int16_t id, int64_t v) {
+        field(id, T_I64);
+        varint(((uint64_t) v << 1) ^ (uint64_t) (v >> 63));
+    }
+
+    void binary(int16_t id, string_view v) {
+        field(id, T_BINARY);
+        listBinary(v);
+    }
+
+    void list(int16_t id, uint8_t type, uint32_t size) {
+        field(id, T_LIST);
+        if (size < 15)
+            buf.push_back((char) ((size << 4) | type));
+        else {
+            buf.push_back((char) (0xf0 | type));
+            varint(size);
+        }
+    }
+
+    void listI32(int32_t v) {
+        varint(((uint32_t) v << 1) ^ (uint32_t) (v >> 31));
+    }
+
+    void listBinary(string_view v) {
+        varint(v.size());
+        buf.append(v.data(), v.size());
+    }
+
+    // Starts a struct that is a field of the current struct
+    void beginStruct(int16_t id) {
+        field(id, T_STRUCT);
+        lastField.push_back(0);
+    }
+
+    // Starts a struct that is an element of a list
+    void beginElement() {
+        lastField.push_back(0);
+    }
+
+    void endStruct() {
+        buf.push_back(0);
+        lastField.pop_back();
+    }
+};
+
+static int32_t physicalType(int kind) {
+    switch (kind) {
+        case ParquetWriter::COLUMN_BOOL:
+            return TYPE_BOOLEAN;
+        case ParquetWriter::COLUMN_INT32:
+        case ParquetWriter::COLUMN_DATE:
+            return TYPE_INT32;
+        case ParquetWriter::COLUMN_INT64:
+        case ParquetWriter::COLUMN_TIMESTAMP:
+            return TYPE_INT64;
+        case ParquetWriter::COLUMN_DOUBLE:
+            return TYPE_DOUBLE;
+    }
+    return TYPE_BYTE_ARRAY;
+}
+
+static void putLE(string &s, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        s.push_back((char) (v & 0xff));
+        v >>= 8;
+    }
+}
+
+ParquetWriter::ParquetWriter(OutputBuffer &out) : out(out) {
+    offset = 0;
+    rows = 0;
+    totalRows = 0;
+    rowGroupSize = DEFAULT_ROW_GROUP;
+}
+
+ParquetWriter::ParquetWriter(OutputBuffer &out, uint32_t rowGroupSize) : out(out) {
+    offset = 0;
+    rows = 0;
+    totalRows = 0;
+    this->rowGroupSize = rowGroupSize ? rowGroupSize : DEFAULT_ROW_GROUP;
+}
+
+// Columns must all be added before begin()
+
+void ParquetWriter::addColumn(string name, int kind) {
+    Column c;
+    c.name = name;
+    c.kind = kind;
+    columns.push_back(c);
+}
+
+void ParquetWriter::begin() {
+    write(MAGIC);
+}
+
+void ParquetWriter::putNull(size_t column) {
+    columns[column].defined.push_back(0);
+}
+
+void ParquetWriter::putString(size_t column, string_view v) {
+    Column &c = columns[column];
+    c.defined.push_back(1);
+    putLE(c.values, v.size(), 4);
+    c.values.append(v.data(), v.size());
+}
+
+void ParquetWriter::putBool(size_t column, bool v) {
+    Column &c = columns[column];
+    c.defined.push_back(1);
+    c.bools.push_back(v);
+}
+
+void ParquetWriter::putInt32(size_t column, int32_t v) {
+    Column &c = columns[column];
+    c.defined.push_back(1);
+    putLE(c.values, (uint32_t) v, 4);
+}
+
+void ParquetWriter::putInt64(size_t column, int64_t v) {
+    Column &c = columns[column];
+    c.defined.push_back(1);
+    putLE(c.values, (uint64_t) v, 8);
+}
+
+void ParquetWriter::putDouble(size_t column, double v) {
+    Column &c = columns[column];
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof (double));
+    c.defined.push_back(1);
+    putLE(c.values, bits, 8);
+}
+
+// Every column must have had exactly one value put since the last row
+
+void ParquetWriter::endRow() {
+    rows++;
+    if (rows >= rowGroupSize)
+        writeRowGroup();
+}
+
+// Writes the last row group and the file footer
+
+void ParquetWriter::finish() {
+    if (rows > 0)
+        writeRowGroup();
+
+    ThriftCompact meta;
+    meta.i32(1, 1);
+
+    meta.list(2, ThriftCompact::T_STRUCT, columns.size() + 1);
+    meta.beginElement();
+    meta.binary(4, "schema");
+    meta.i32(5, columns.size());
+    meta.endStruct();
+
+    for (const Column &c : columns) {
+        meta.beginElement();
+        meta.i32(1, physicalType(c.kind));
+        meta.i32(3, REPETITION_OPTIONAL);
+        meta.binary(4, c.name);
+        if (c.kind == COLUMN_STRING)
+            meta.i32(6, CONVERTED_UTF8);
+        else if (c.kind == COLUMN_DATE)
+            meta.i32(6, CONVERTED_DATE);
+        else if (c.kind == COLUMN_TIMESTAMP)
+            meta.i32(6, CONVERTED_TIMESTAMP_MILLIS);
+        meta.endStruct();
+    }
+
+    meta.i64(3, totalRows);
+
+    meta.list(4, ThriftCompact::T_STRUCT, groups.size());
+    for (size_t g = 0; g < groups.size(); g++) {
+        uint64_t groupSize = 0;
+        meta.beginElement();
+        meta.list(1, ThriftCompact::T_STRUCT, columns.size());
+        for (size_t i = 0; i < columns.size(); i++) {
+            const ChunkInfo &chunk = groups[g][i];
+            groupSize += chunk.size;
+
+            meta.beginElement();
+            meta.i64(2, chunk.offset);
+            meta.beginStruct(3);
+            meta.i32(1, physicalType(columns[i].kind));
+            meta.list(2, ThriftCompact::T_I32, 2);
+            meta.listI32(ENCODING_PLAIN);
+            meta.listI32(ENCODING_RLE);
+            meta.list(3, ThriftCompact::T_BINARY, 1);
+            meta.listBinary(columns[i].name);
+            meta.i32(4, CODEC_UNCOMPRESSED);
+            meta.i64(5, groupRows[g]);
+            meta.i64(6, chunk.size);
+            meta.i64(7, chunk.size);
+            meta.i64(9, chunk.offset);
+            meta.endStruct();
+            meta.endStruct();
+        }
+        meta.i64(2, groupSize);
+        meta.i64(3, groupRows[g]);
+        meta.endStruct();
+    }
+
+    meta.binary(6, "dbftool");
+    meta.buf.push_back(0);
+
+    string length;
+    putLE(length, meta.buf.size(), 4);
+
+    write(meta.buf);
+    write(length);
+    write(MAGIC);
+}
+
+void ParquetWriter::write(string_view data) {
+    out.append(data);
+    offset += data.size();
+}
+
+// Writes one data page per column for the rows collected so far. Definition
+// levels are a single bit packed run of the RLE hybrid encoding.
+
+void ParquetWriter::writeRowGroup() {
+    vector<ChunkInfo> chunks;
+    string page;
+
+    for (Column &c : columns) {
+        page.clear();
+
+        uint32_t groupCount = (rows + 7) / 8;
+        ThriftCompact levels;
+        levels.varint(((uint64_t) groupCount << 1) | 1);
+        size_t packedAt = levels.buf.size();
+        levels.buf.append(groupCount, '\0');
+        for (uint32_t r = 0; r < rows; r++)
+            if (c.defined[r])
+                levels.buf[packedAt + (r / 8)] |= (char) (1 << (r % 8));
+
+        putLE(page, levels.buf.size(), 4);
+        page.append(levels.buf);
+
+        if (c.kind == COLUMN_BOOL) {
+            size_t packedValues = page.size();
+            page.append((c.bools.size() + 7) / 8, '\0');
+            for (size_t i = 0; i < c.bools.size(); i++)
+                if (c.bools[i])
+                    page[packedValues + (i / 8)] |= (char) (1 << (i % 8));
+        } else page.append(c.values);
+
+        ThriftCompact header;
+        header.i32(1, PAGE_DATA);
+        header.i32(2, page.size());
+        header.i32(3, page.size());
+        header.beginStruct(5);
+        header.i32(1, rows);
+        header.i32(2, ENCODING_PLAIN);
+        header.i32(3, ENCODING_RLE);
+        header.i32(4, ENCODING_RLE);
+        header.endStruct();
+        header.buf.push_back(0);
+
+        ChunkInfo chunk;
+        chunk.offset = offset;
+        chunk.size = header.buf.size() + page.size();
+        chunks.push_back(chunk);
+
+        write(header.buf);
+        write(page);
+
+        c.values.clear();
+        c.defined.clear();
+        c.bools.clear();
+    }
+
+    groups.push_back(chunks);
+    groupRows.push_back(rows);
+    totalRows += rows;
+    rows = 0;
+}
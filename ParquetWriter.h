@@ -0,0 +1,99 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ParquetWriter.h
+ * Author: Heath Leach
+ *
+ * Created on October 17, 2026, 10:50 AM
+ */
+
+#ifndef PARQUETWRITER_H
+#define	PARQUETWRITER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+#include "OutputBuffer.h"
+
+// Writes a Parquet file to an OutputBuffer, one row at a time. Each column
+// collects its values for the current row group in its own buffer, and a
+// full row group is written out as one uncompressed, PLAIN encoded data page
+// per column. All columns are optional so blank values can be stored as
+// nulls. Offsets are counted as the file is written, so the output does not
+// need to be seekable.
+
+class ParquetWriter {
+public:
+    static const int COLUMN_STRING = 0; // UTF-8 byte array
+    static const int COLUMN_BOOL = 1;
+    static const int COLUMN_INT32 = 2;
+    static const int COLUMN_INT64 = 3;
+    static const int COLUMN_DOUBLE = 4;
+    static const int COLUMN_DATE = 5; // Days since 1970-01-01
+    static const int COLUMN_TIMESTAMP = 6; // Milliseconds since 1970-01-01
+    static const uint32_t DEFAULT_ROW_GROUP = 128 * 1024;
+private:
+
+    struct Column {
+        std::string name; // Column name
+        int kind; // One of the COLUMN_ constants
+        std::string values; // PLAIN encoded values of the current row group
+        std::vector<uint8_t> defined; // 1 for each non null row
+        std::vector<uint8_t> bools; // Values of a bool column before packing
+    };
+
+    struct ChunkInfo {
+        uint64_t offset; // File offset of the page header
+        uint64_t size; // Size of the page header and page
+    };
+
+    OutputBuffer &out; // Destination
+    std::vector<Column> columns; // Columns in schema order
+    std::vector<std::vector<ChunkInfo>> groups; // Chunks of each written row group
+    std::vector<uint32_t> groupRows; // Rows in each written row group
+    uint64_t offset; // Bytes written so far
+    uint32_t rows; // Rows in the current row group
+    uint64_t totalRows; // Rows in all row groups
+    uint32_t rowGroupSize; // Rows per row group
+public:
+    ParquetWriter(OutputBuffer &out);
+    ParquetWriter(OutputBuffer &out, uint32_t rowGroupSize);
+    void addColumn(std::string name, int kind);
+    void begin();
+    void putNull(size_t column);
+    void putString(size_t column, std::string_view v);
+    void putBool(size_t column, bool v);
+    void putInt32(size_t column, int32_t v);
+    void putInt64(size_t column, int64_t v);
+    void putDouble(size_t column, double v);
+    void endRow();
+    void finish();
+private:
+    void write(std::string_view data);
+    void writeRowGroup();
+};
+
+#endif	/* PARQUETWRITER_H */
+
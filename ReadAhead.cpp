@@ -0,0 +1,188 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ReadAhead.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 18, 2026, 5:10 PM
+ */
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ReadAhead.h"
+
+using namespace std;
+
+ReadAhead::ReadAhead() {
+    fd = -1;
+    offset = 0;
+    step = 0;
+    size = 0;
+    chunks = 0;
+    nextRead = 0;
+    consumed = 0;
+    failed = false;
+    stopping = false;
+}
+
+ReadAhead::~ReadAhead() {
+    stop();
+}
+
+// Opens fileName and starts depth reader threads on its chunks. Returns
+// false if the file can't be opened.
+
+bool ReadAhead::start(const string &fileName, uint64_t offset, size_t step, size_t size,
+        uint64_t chunks, unsigned depth) {
+    stop();
+
+    fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, offset, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    if (depth == 0)
+        depth = 1;
+
+    this->offset = offset;
+    this->step = step;
+    this->size = size;
+    this->chunks = chunks;
+    nextRead = 0;
+    consumed = 0;
+    failed = false;
+    stopping = false;
+
+    buffers.resize(depth + 1);
+    for (vector<char> &buf : buffers)
+        buf.resize(size);
+    lengths.assign(depth + 1, 0);
+    held.assign(depth + 1, UINT64_MAX);
+
+    for (unsigned i = 0; i < depth; i++)
+        workers.push_back(thread(&ReadAhead::run, this));
+    return true;
+}
+
+// Returns the next chunk and puts the number of bytes read into it in len,
+// which is short of the chunk size only at the end of the file. Returns
+// NULL once every chunk has been handed out or if a read failed.
+
+const char *ReadAhead::next(size_t &len) {
+    unique_lock<mutex> guard(lock);
+
+    if ((fd < 0) || (consumed >= chunks))
+        return NULL;
+
+    size_t slot = consumed % buffers.size();
+    changed.wait(guard, [&]() {
+        return (held[slot] == consumed) || failed;
+    });
+
+    if (held[slot] != consumed)
+        return NULL;
+
+    // Moving on frees the buffer of the previous chunk for the readers
+    len = lengths[slot];
+    consumed++;
+    changed.notify_all();
+    return buffers[slot].data();
+}
+
+bool ReadAhead::isRunning() {
+    return fd >= 0;
+}
+
+bool ReadAhead::fail() {
+    lock_guard<mutex> guard(lock);
+    return failed;
+}
+
+void ReadAhead::stop() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    changed.notify_all();
+
+    for (thread &worker : workers)
+        worker.join();
+    workers.clear();
+
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+}
+
+// Body of the reader threads. Each takes the next chunk whose buffer is free,
+// that is one the reader has moved past, and reads it.
+
+void ReadAhead::run() {
+    unique_lock<mutex> guard(lock);
+
+    while (true) {
+        // The reader holds chunk consumed - 1 until its next call to next()
+        changed.wait(guard, [&]() {
+            return stopping || failed || (nextRead >= chunks) ||
+                    (nextRead + 1 < consumed + buffers.size());
+        });
+
+        if (stopping || failed || (nextRead >= chunks))
+            return;
+
+        uint64_t chunk = nextRead++;
+        size_t slot = chunk % buffers.size();
+        char *buf = buffers[slot].data();
+        off_t pos = offset + chunk * step;
+        size_t got = 0;
+        bool error = false;
+
+        guard.unlock();
+
+        while (got < size) {
+            ssize_t n = pread(fd, buf + got, size - got, pos + got);
+            if ((n < 0) && (errno == EINTR))
+                continue;
+            if (n <= 0) {
+                error = (n < 0);
+                break;
+            }
+            got += n;
+        }
+
+        guard.lock();
+
+        if (error)
+            failed = true;
+        else {
+            lengths[slot] = got;
+            held[slot] = chunk;
+        }
+        changed.notify_all();
+    }
+}
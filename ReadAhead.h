@@ -0,0 +1,81 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ReadAhead.h
+ * Author: Heath Leach
+ *
+ * Created on October 18, 2026, 5:10 PM
+ */
+
+#ifndef READAHEAD_H
+#define	READAHEAD_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+// Reads a file in order in fixed size chunks ahead of the reading thread,
+// with a reader thread per read in flight, so that on storage where each
+// read waits on the network several reads overlap instead of queueing up
+// behind one another. Chunk i is size bytes read at offset + i * step;
+// size may be larger than step for chunks that overlap.
+//
+// Chunks are read into a ring of depth + 1 buffers and handed to the reader
+// in place. A chunk stays valid until the next call to next(), after which
+// its buffer is reused by the reader threads.
+
+class ReadAhead {
+private:
+    int fd; // The file being read, or -1
+    uint64_t offset; // Position of the first chunk
+    size_t step; // Distance between chunks
+    size_t size; // Bytes read for each chunk
+    uint64_t chunks; // Number of chunks to read
+    std::vector<std::thread> workers; // One per read in flight
+    std::mutex lock;
+    std::condition_variable changed; // Signalled when a chunk is read or released
+    std::vector<std::vector<char>> buffers; // Ring of chunk buffers
+    std::vector<size_t> lengths; // Bytes read into each buffer
+    std::vector<uint64_t> held; // Chunk each buffer holds once read, or UINT64_MAX
+    uint64_t nextRead; // Next chunk for a reader thread to read
+    uint64_t consumed; // Chunks handed to the reader so far
+    bool failed; // True once a read has failed
+    bool stopping; // Tells the reader threads to give up
+public:
+    ReadAhead();
+    ~ReadAhead();
+    bool start(const std::string &fileName, uint64_t offset, size_t step, size_t size,
+            uint64_t chunks, unsigned depth);
+    const char *next(size_t &len);
+    bool isRunning();
+    bool fail();
+    void stop();
+private:
+    void run();
+};
+
+#endif	/* READAHEAD_H */
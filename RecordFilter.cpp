@@ -0,0 +1,341 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   RecordFilter.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 16, 2026, 1:20 PM
+ */
+
+#include <cctype>
+#include "FieldDecode.h"
+#include "FieldScan.h"
+#include "RecordFilter.h"
+
+using namespace std;
+
+static string_view trimSpaces(string_view v) {
+    size_t first = v.find_first_not_of(' ');
+    if (first == string_view::npos)
+        return string_view();
+    return v.substr(first, v.find_last_not_of(' ') - first + 1);
+}
+
+RecordFilter::RecordFilter() {
+    pos = 0;
+}
+
+// Compiles expression against the fields of dbf. An empty expression
+// matches every record. Returns false and sets the error on failure.
+
+bool RecordFilter::open(string expression, DBFActor &dbf) {
+    nodes.clear();
+    error = "";
+    expr = expression;
+    pos = 0;
+
+    skipSpace();
+    if (pos == expr.length())
+        return true;
+
+    if (parseOr(dbf) < 0)
+        return false;
+
+    skipSpace();
+    if (pos != expr.length()) {
+        fail("unexpected '" + expr.substr(pos) + "'");
+        return false;
+    }
+
+    return true;
+}
+
+bool RecordFilter::empty() const {
+    return nodes.empty();
+}
+
+bool RecordFilter::matches(const DBFRecordView &rec) const {
+    if (nodes.empty())
+        return true;
+    return eval(nodes.size() - 1, rec);
+}
+
+// Sets hits[i] for every record i of block that matches
+
+void RecordFilter::matchBlock(const DBFBlock &block, vector<uint8_t> &hits) const {
+    if (simple()) {
+        const Node &n = nodes[0];
+        scanFieldEquals(block, n.field.fieldOffset, n.field.fieldInfo.length,
+                n.value, n.op == OP_PREFIX, hits);
+        return;
+    }
+
+    hits.resize(block.count);
+    for (uint32_t i = 0; i < block.count; i++)
+        hits[i] = matches(block.record(i));
+}
+
+// True if the filter is a single byte wise = or ^= comparison that
+// scanFieldEquals() can evaluate
+
+bool RecordFilter::simple() const {
+    if (nodes.size() != 1)
+        return false;
+
+    const Node &n = nodes[0];
+
+    if (((n.op != OP_EQ) && (n.op != OP_PREFIX)) || n.numeric)
+        return false;
+
+    return n.value.empty() || ((n.value.front() != ' ') && (n.value.back() != ' '));
+}
+
+// Returns the compiled expression, the root being the last node
+
+const vector<RecordFilter::Node> &RecordFilter::getNodes() const {
+    return nodes;
+}
+
+string RecordFilter::getError() {
+    return error;
+}
+
+bool RecordFilter::eval(int node, const DBFRecordView &rec) const {
+    const Node &n = nodes[node];
+
+    switch (n.op) {
+        case OP_AND:
+            return eval(n.left, rec) && eval(n.right, rec);
+        case OP_OR:
+            return eval(n.left, rec) || eval(n.right, rec);
+        case OP_NOT:
+            return !eval(n.left, rec);
+        default:
+            if (n.numeric)
+                return compare(n, rec.get(n.field));
+            return compare(n, trimSpaces(rec.get(n.field)));
+    }
+}
+
+bool RecordFilter::compare(const Node &n, string_view v) const {
+    if (n.op == OP_PREFIX)
+        return v.substr(0, n.value.length()) == n.value;
+
+    int cmp;
+    int cmpHigh = 0;
+
+    if (n.numeric) {
+        double d;
+        if (!fieldDouble(n.field, v, d))
+            return n.op == OP_NE;
+        cmp = d < n.number ? -1 : (d > n.number ? 1 : 0);
+        if (n.op == OP_RANGE)
+            cmpHigh = d < n.highNumber ? -1 : (d > n.highNumber ? 1 : 0);
+    } else {
+        cmp = v.compare(n.value);
+        if (n.op == OP_RANGE)
+            cmpHigh = v.compare(n.high);
+    }
+
+    switch (n.op) {
+        case OP_EQ:
+            return cmp == 0;
+        case OP_NE:
+            return cmp != 0;
+        case OP_LT:
+            return cmp < 0;
+        case OP_LE:
+            return cmp <= 0;
+        case OP_GT:
+            return cmp > 0;
+        case OP_GE:
+            return cmp >= 0;
+        case OP_RANGE:
+            return (cmp >= 0) && (cmpHigh <= 0);
+    }
+
+    return false;
+}
+
+int RecordFilter::parseOr(DBFActor &dbf) {
+    int left = parseAnd(dbf);
+
+    while ((left >= 0) && accept("||")) {
+        int right = parseAnd(dbf);
+        if (right < 0)
+            return -1;
+
+        Node n = Node();
+        n.op = OP_OR;
+        n.left = left;
+        n.right = right;
+        nodes.push_back(n);
+        left = nodes.size() - 1;
+    }
+
+    return left;
+}
+
+int RecordFilter::parseAnd(DBFActor &dbf) {
+    int left = parseFactor(dbf);
+
+    while ((left >= 0) && accept("&&")) {
+        int right = parseFactor(dbf);
+        if (right < 0)
+            return -1;
+
+        Node n = Node();
+        n.op = OP_AND;
+        n.left = left;
+        n.right = right;
+        nodes.push_back(n);
+        left = nodes.size() - 1;
+    }
+
+    return left;
+}
+
+int RecordFilter::parseFactor(DBFActor &dbf) {
+    if (accept("(")) {
+        int inner = parseOr(dbf);
+        if (inner < 0)
+            return -1;
+        if (!accept(")"))
+            return fail("missing ')'");
+        return inner;
+    }
+
+    if (accept("!")) {
+        int inner = parseFactor(dbf);
+        if (inner < 0)
+            return -1;
+
+        Node n = Node();
+        n.op = OP_NOT;
+        n.left = inner;
+        nodes.push_back(n);
+        return nodes.size() - 1;
+    }
+
+    return parseComparison(dbf);
+}
+
+int RecordFilter::parseComparison(DBFActor &dbf) {
+    skipSpace();
+
+    size_t start = pos;
+    while ((pos < expr.length()) && (isalnum((unsigned char) expr[pos]) || (expr[pos] == '_')))
+        pos++;
+
+    string name = expr.substr(start, pos - start);
+    if (name == "")
+        return fail("expected a field name at '" + expr.substr(start) + "'");
+
+    Node n = Node();
+
+    if (!dbf.findField(name, n.field))
+        return fail("unknown field " + name);
+
+    if (accept("!="))
+        n.op = OP_NE;
+    else if (accept("^="))
+        n.op = OP_PREFIX;
+    else if (accept("<="))
+        n.op = OP_LE;
+    else if (accept(">="))
+        n.op = OP_GE;
+    else if (accept("="))
+        n.op = OP_EQ;
+    else if (accept("<"))
+        n.op = OP_LT;
+    else if (accept(">"))
+        n.op = OP_GT;
+    else if (accept(":"))
+        n.op = OP_RANGE;
+    else return fail("expected an operator after " + name);
+
+    n.value = parseValue();
+
+    if (n.op == OP_RANGE) {
+        size_t dots = n.value.find("..");
+        if (dots == string::npos)
+            return fail("expected low..high after " + name + ":");
+        n.high = n.value.substr(dots + 2);
+        n.value = n.value.substr(0, dots);
+    }
+
+    n.numeric = fieldIsNumeric(n.field) && (n.op != OP_PREFIX);
+
+    if (n.numeric) {
+        if (!decodeNumber(n.value, n.number) ||
+                ((n.op == OP_RANGE) && !decodeNumber(n.high, n.highNumber)))
+            return fail("expected a number to compare " + name + " with");
+    }
+
+    nodes.push_back(n);
+    return nodes.size() - 1;
+}
+
+// Reads a value, either double quoted or running up to the next space,
+// parenthesis or logical operator
+
+string RecordFilter::parseValue() {
+    skipSpace();
+
+    if ((pos < expr.length()) && (expr[pos] == '"')) {
+        size_t end = expr.find('"', pos + 1);
+        if (end == string::npos)
+            end = expr.length();
+        string v = expr.substr(pos + 1, end - pos - 1);
+        pos = end < expr.length() ? end + 1 : end;
+        return v;
+    }
+
+    size_t start = pos;
+    while ((pos < expr.length()) && (expr[pos] != ' ') && (expr[pos] != ')') &&
+            (expr.compare(pos, 2, "&&") != 0) && (expr.compare(pos, 2, "||") != 0))
+        pos++;
+
+    return expr.substr(start, pos - start);
+}
+
+void RecordFilter::skipSpace() {
+    while ((pos < expr.length()) && isspace((unsigned char) expr[pos]))
+        pos++;
+}
+
+bool RecordFilter::accept(const char *token) {
+    skipSpace();
+    size_t len = char_traits<char>::length(token);
+    if (expr.compare(pos, len, token) != 0)
+        return false;
+    pos += len;
+    return true;
+}
+
+int RecordFilter::fail(string message) {
+    if (error == "")
+        error = message;
+    return -1;
+}
@@ -0,0 +1,106 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   RecordFilter.h
+ * Author: Heath Leach
+ *
+ * Created on October 16, 2026, 1:20 PM
+ */
+
+#ifndef RECORDFILTER_H
+#define	RECORDFILTER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DBFActor.h"
+
+// A -w filter compiled against the schema of a dbf. Expressions are
+// comparisons joined with && and ||, optionally negated with ! and grouped
+// with parentheses:
+//
+//     NAME=value    NAME!=value    NAME^=prefix    NAME:low..high
+//     NAME<value    NAME<=value    NAME>value      NAME>=value
+//
+// Values may be double quoted to hold spaces or operator characters. Numeric
+// fields (N, F and the Visual FoxPro I, B and Y types) are compared as
+// numbers, everything else byte by byte after trimming spaces. Evaluation works on the
+// raw record data and stops at the first comparison that decides the result.
+// A lone = or ^= on a non numeric field is run over whole blocks at a time by
+// the vectorized scanFieldEquals().
+
+class RecordFilter {
+public:
+    static const int OP_AND = 0;
+    static const int OP_OR = 1;
+    static const int OP_NOT = 2;
+    static const int OP_EQ = 3;
+    static const int OP_NE = 4;
+    static const int OP_LT = 5;
+    static const int OP_LE = 6;
+    static const int OP_GT = 7;
+    static const int OP_GE = 8;
+    static const int OP_PREFIX = 9;
+    static const int OP_RANGE = 10;
+
+    struct Node {
+        int op; // One of the OP_ constants
+        int left; // First operand of AND, OR and NOT
+        int right; // Second operand of AND and OR
+        DBFField field; // Field compared by the comparison operators
+        bool numeric; // Compare as numbers instead of bytes
+        std::string value; // Value compared against, or low end of a range
+        std::string high; // High end of a range
+        double number; // value as a number when numeric
+        double highNumber; // high as a number when numeric
+    };
+private:
+    std::vector<Node> nodes; // Compiled expression, the root is the last node
+    std::string error; // Description of the last compile error
+    std::string expr; // Expression being compiled
+    size_t pos; // Compile position in expr
+public:
+    RecordFilter();
+    bool open(std::string expression, DBFActor &dbf);
+    bool empty() const;
+    bool matches(const DBFRecordView &rec) const;
+    void matchBlock(const DBFBlock &block, std::vector<uint8_t> &hits) const;
+    bool simple() const;
+    const std::vector<Node> &getNodes() const;
+    std::string getError();
+private:
+    bool eval(int node, const DBFRecordView &rec) const;
+    bool compare(const Node &n, std::string_view v) const;
+    int parseOr(DBFActor &dbf);
+    int parseAnd(DBFActor &dbf);
+    int parseFactor(DBFActor &dbf);
+    int parseComparison(DBFActor &dbf);
+    std::string parseValue();
+    void skipSpace();
+    bool accept(const char *token);
+    int fail(std::string message);
+};
+
+#endif	/* RECORDFILTER_H */
+
@@ -0,0 +1,137 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ScanStats.cpp
+ * Author: Heath Leach
+ * 
+ * Created on October 18, 2026, 2:30 PM
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <sys/resource.h>
+#include "ScanStats.h"
+
+using namespace std;
+
+ScanStats::ScanStats() {
+    io = DBFIOStats();
+    scanned = 0;
+    deleted = 0;
+    filtered = 0;
+    emitted = 0;
+    readNanos = 0;
+    formatNanos = 0;
+    writeNanos = 0;
+    bytesWritten = 0;
+    allocations = 0;
+    totalNanos = 0;
+}
+
+// Adds the counts of other, except for the wall clock time
+
+void ScanStats::add(const ScanStats &other) {
+    addIO(other.io);
+    scanned += other.scanned;
+    deleted += other.deleted;
+    filtered += other.filtered;
+    emitted += other.emitted;
+    readNanos += other.readNanos;
+    formatNanos += other.formatNanos;
+    writeNanos += other.writeNanos;
+    bytesWritten += other.bytesWritten;
+    allocations += other.allocations;
+}
+
+void ScanStats::addIO(const DBFIOStats &other) {
+    io.headerNanos += other.headerNanos;
+    io.bytesRead += other.bytesRead;
+    io.readCalls += other.readCalls;
+}
+
+// Returns a monotonic time in nanoseconds for timing with
+
+uint64_t nanoTime() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Returns the peak resident set size of the process in bytes
+
+uint64_t peakMemory() {
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return (uint64_t) usage.ru_maxrss * 1024;
+#endif
+}
+
+static string seconds(uint64_t nanos) {
+    char buf[32];
+    snprintf(buf, sizeof (buf), "%.6f", nanos / 1e9);
+    return buf;
+}
+
+// Prints stats to out as aligned text, or as a single JSON object
+
+void printStats(ostream &out, const ScanStats &stats, unsigned threads, bool json) {
+    uint64_t memory = peakMemory();
+
+    if (json) {
+        out << "{\"threads\":" << threads
+                << ",\"header_seconds\":" << seconds(stats.io.headerNanos)
+                << ",\"bytes_read\":" << stats.io.bytesRead
+                << ",\"read_calls\":" << stats.io.readCalls
+                << ",\"records_scanned\":" << stats.scanned
+                << ",\"records_deleted\":" << stats.deleted
+                << ",\"records_filtered\":" << stats.filtered
+                << ",\"records_emitted\":" << stats.emitted
+                << ",\"read_seconds\":" << seconds(stats.readNanos)
+                << ",\"format_seconds\":" << seconds(stats.formatNanos)
+                << ",\"write_seconds\":" << seconds(stats.writeNanos)
+                << ",\"bytes_written\":" << stats.bytesWritten
+                << ",\"heap_allocations\":" << stats.allocations
+                << ",\"total_seconds\":" << seconds(stats.totalNanos)
+                << ",\"peak_memory_bytes\":" << memory << "}" << endl;
+        return;
+    }
+
+    out << "dbftool stats, " << threads << (threads == 1 ? " thread" : " threads") << endl;
+    out << "    header parse     : " << seconds(stats.io.headerNanos) << " s" << endl;
+    out << "    bytes read       : " << stats.io.bytesRead << " in " << stats.io.readCalls << " read calls" << endl;
+    out << "    records scanned  : " << stats.scanned << endl;
+    out << "    records deleted  : " << stats.deleted << endl;
+    out << "    records filtered : " << stats.filtered << endl;
+    out << "    records emitted  : " << stats.emitted << endl;
+    out << "    reading          : " << seconds(stats.readNanos) << " s" << endl;
+    out << "    formatting       : " << seconds(stats.formatNanos) << " s" << endl;
+    out << "    writing          : " << seconds(stats.writeNanos) << " s, " << stats.bytesWritten << " bytes" << endl;
+    out << "    heap allocations : " << stats.allocations << endl;
+    out << "    total            : " << seconds(stats.totalNanos) << " s" << endl;
+    out << "    peak memory      : " << memory / 1024 << " KB" << endl;
+}
@@ -0,0 +1,64 @@
+//
+// The MIT License
+//
+// Copyright (c) 2015 Heath Leach
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* 
+ * File:   ScanStats.h
+ * Author: Heath Leach
+ *
+ * Created on October 18, 2026, 2:30 PM
+ */
+
+#ifndef SCANSTATS_H
+#define	SCANSTATS_H
+
+#include <ostream>
+#include <stdint.h>
+#include "DBFActor.h"
+
+// Counters and timers for one dump, printed by --stats so that a slow run
+// can be put down to reading, formatting or writing. Times taken on worker
+// threads are summed over the threads, so with -j they can add up to more
+// than the wall clock time.
+
+struct ScanStats {
+    DBFIOStats io; // Reads done by every DBFActor used
+    uint64_t scanned; // Records looked at
+    uint64_t deleted; // Records passed over because they are marked deleted
+    uint64_t filtered; // Records that didn't match the filter
+    uint64_t emitted; // Records written to the output
+    uint64_t readNanos; // Time spent reading records
+    uint64_t formatNanos; // Time spent filtering and formatting records
+    uint64_t writeNanos; // Time spent writing the output
+    uint64_t bytesWritten; // Bytes of output written
+    uint64_t allocations; // Heap allocations made while scanning
+    uint64_t totalNanos; // Wall clock time of the run
+    ScanStats();
+    void add(const ScanStats &other);
+    void addIO(const DBFIOStats &other);
+};
+
+uint64_t nanoTime();
+uint64_t peakMemory();
+void printStats(std::ostream &out, const ScanStats &stats, unsigned threads, bool json);
+
+#endif	/* SCANSTATS_H */
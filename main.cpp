@@ -28,39 +28,225 @@
  * Created on August 15, 2015, 7:47 AM
  */
 
+#include <charconv>
+#include <climits>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
-#include <iomanip>
+#include <limits>
 #include <algorithm>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+#include <glob.h>
+#include <strings.h>
+#include <unistd.h>
+#include "Aggregator.h"
+#include "Arena.h"
+#include "Base94.h"
+#include "DBFIndex.h"
+#include "FieldDecode.h"
 #include "FieldOptions.h"
+#include "HeapCounter.h"
+#include "OutputBuffer.h"
+#include "ParallelScan.h"
+#include "ParquetWriter.h"
+#include "RecordFilter.h"
+#include "ScanStats.h"
 
 using namespace std;
 
 string fields = "*";
 string fileName = "";
+vector<string> fileNames;
 string match = "";
 string fields94 = "";
 string indexFieldName = "";
+string indexBuildField = "";
+string packFileName = "";
+string groupFields = "";
+string aggregates = "";
 bool doFieldDump = false;
 bool doColumnDump = false;
+bool doMapped = false;
+bool doNormalize = false;
+bool doParquet = false;
+bool doDeleted = false;
+bool doStats = false;
+bool doStatsJson = false;
+bool doAggregate = false;
+size_t blockSize = DBFActor::DEFAULT_BLOCK_SIZE;
 
 DBFActor dbf;
 FieldOptions fopt;
+FieldPlan plan;
+FieldPlan columns;
+RecordFilter filter;
+Aggregator totals;
+vector<uint> widths;
+OutputBuffer output(STDOUT_FILENO);
+ParquetWriter parquet(output);
+vector<int> kinds;
+uint b94Columns = 0;
+string delim = ",";
+uint threads = 1;
+uint readAhead = 0;
+ScanStats stats;
+
+// Base 94 values of a row decoded ahead by dump_block, one per -9 column in
+// plan order
+
+struct B94Row {
+    const uint64_t *values;
+    const uint8_t *results;
+};
+
+// Working space for formatting a block, one per thread
+
+struct BlockScratch {
+    vector<uint8_t> hits;
+    vector<uint64_t> b94Values;
+    vector<uint8_t> b94Results;
+    ScanStats stats;
+    Aggregator partial;
+    Arena arena;
+};
+
+// What was resolved for the last file accepted for the dump. plan, filter
+// and b94Columns are put back from it when a file is rejected, so that the
+// files after it are compared with, and dumped against, an accepted file.
+
+struct AcceptedFields {
+    RecordVec descriptors;
+    FieldPlan plan;
+    RecordFilter filter;
+    uint b94Columns;
+};
+
+AcceptedFields accepted;
 
 void do_help() {
     cout << "dbftool - select and dump values from a dbf." << endl;
     cout << endl;
     cout << "    -s <fields>   : Fields to display, comma separated. Defaults to all." << endl;
-    cout << "    -f <file.dbf> : Name of DBF file." << endl;
+    cout << "    -f <file.dbf> : Name of DBF file, or - to read it from stdin. Can be given more" << endl;
+    cout << "                    than once, as a quoted glob such as \"data/*.dbf\" or as @list" << endl;
+    cout << "                    for a file of names, one per line. gzip and zstd compressed" << endl;
+    cout << "                    files are read directly; zstd ones need the zstd command in PATH." << endl;
     cout << "    -9 <fields>   : Decode field as base 94, comma separated. Defaults to none." << endl;
     cout << "    -i <name>     : Index field name. Add an index field to the output." << endl;
+    cout << "    -w <filter>   : Only output records matching filter. Comparisons are" << endl;
+    cout << "                    NAME=v, !=, <, <=, >, >=, ^= (prefix) and NAME:low..high," << endl;
+    cout << "                    joined with &&, || and !, e.g. \"ACCTNO=12 && AMT>=10\"." << endl;
+    cout << "    -x <field>    : Build an index on field for -w lookups and exit." << endl;
+    cout << "    -g <fields>   : Output one row per distinct value of these fields, comma" << endl;
+    cout << "                    separated, with the aggregates of -t instead of the records." << endl;
+    cout << "    -t <aggs>     : Aggregates to output, comma separated, of COUNT, SUM(field)," << endl;
+    cout << "                    MIN(field) and MAX(field). Defaults to COUNT. Without -g" << endl;
+    cout << "                    they are taken over all the records." << endl;
+    cout << "    -k <file.dbf> : Pack the records not marked deleted into a new dbf and exit." << endl;
+    cout << "    -a            : Include records marked deleted in the output." << endl;
     cout << "    -d            : Dump fields and exit." << endl;
-    cout << "    -c            : Output fields spaced by field length." << endl;
+    cout << "    -c            : Output fields spaced by field length. Memo text is cut to" << endl;
+    cout << "                    40 characters on a single line." << endl;
+    cout << "    -n            : Output numbers, dates and logicals in a normalized form." << endl;
+    cout << "    -p            : Output a Parquet file instead of text." << endl;
+    cout << "    -m            : Memory map the file instead of reading it." << endl;
+    cout << "    -b <MB>       : Size of each read in megabytes. Defaults to 4." << endl;
+    cout << "    -j <threads>  : Format records on this many threads. Defaults to 1." << endl;
+    cout << "    -r <reads>    : Keep this many reads in flight ahead of formatting. Defaults to 0." << endl;
+    cout << "    --stats       : Print counts and timings of reading and formatting to stderr." << endl;
+    cout << "    --stats=json  : The same, as a JSON object." << endl;
     cout << endl;
     exit(1);
 }
 
+// Adds the dbfs arg names to fileNames: the names listed one per line in the
+// file after an @, the matches of a glob pattern, or else arg itself
+
+void add_files(const string &arg) {
+    if ((arg.length() > 1) && (arg[0] == '@')) {
+        ifstream list(arg.substr(1));
+        if (!list.is_open()) {
+            cout << "Could not open " << arg.substr(1) << "." << endl;
+            exit(1);
+        }
+
+        string line;
+        while (getline(list, line)) {
+            if (!line.empty() && (line.back() == '\r'))
+                line.pop_back();
+            if (!line.empty())
+                fileNames.push_back(line);
+        }
+        return;
+    }
+
+    if (arg.find_first_of("*?[") == string::npos) {
+        fileNames.push_back(arg);
+        return;
+    }
+
+    glob_t matches;
+    if (glob(arg.c_str(), 0, NULL, &matches) != 0) {
+        cout << "No files match " << arg << "." << endl;
+        exit(1);
+    }
+
+    for (size_t i = 0; i < matches.gl_pathc; i++)
+        fileNames.push_back(matches.gl_pathv[i]);
+    globfree(&matches);
+}
+
+// Returns the message for fileName failing to open
+
+string open_failure() {
+    if (dbf.getStatus().error == DBFActor::STATUS_NO_DECOMPRESSOR)
+        return "Could not open " + fileName + ": zstd was not found in PATH.";
+    return "Could not open " + fileName + ".";
+}
+
+bool open_dbf() {
+    if (fileName == "-")
+        dbf.openStream(STDIN_FILENO);
+    else if (doMapped)
+        dbf.openMapped(fileName);
+    else dbf.open(fileName);
+
+    return dbf.getStatus().error == DBFActor::STATUS_READY;
+}
+
+// Resolves the field selection and the filter against the fields of dbf.
+// Returns false if the filter doesn't fit them.
+
+bool resolve_fields() {
+    fopt.open(fields, fields94, dbf);
+    plan = fopt.plan(dbf);
+    b94Columns = count_if(plan.begin(), plan.end(), [](const FieldSelection &sel) {
+        return sel.b94;
+    });
+
+    return filter.open(match, dbf);
+}
+
+// Keeps the fields resolved for dbf as those of the last accepted file
+
+void accept_fields() {
+    accepted.descriptors = dbf.getDescriptors();
+    accepted.plan = plan;
+    accepted.filter = filter;
+    accepted.b94Columns = b94Columns;
+}
+
+// Puts back the fields of the last accepted file after one was rejected
+
+void restore_fields() {
+    plan = accepted.plan;
+    filter = accepted.filter;
+    b94Columns = accepted.b94Columns;
+}
+
 void setup(int argc, char* argv[]) {
     if (argc == 1)
         do_help();
@@ -76,7 +262,7 @@ void setup(int argc, char* argv[]) {
             if (arg == "-f") {
             i++;
             if (i < argc)
-                fileName = argv[i];
+                add_files(argv[i]);
             else do_help();
         } else
             if (arg == "-9") {
@@ -90,12 +276,72 @@ void setup(int argc, char* argv[]) {
             if (i < argc)
                 indexFieldName = argv[i];
             else do_help();
+        } else
+            if (arg == "-x") {
+            i++;
+            if (i < argc)
+                indexBuildField = argv[i];
+            else do_help();
+        } else
+            if (arg == "-k") {
+            i++;
+            if (i < argc)
+                packFileName = argv[i];
+            else do_help();
         } else
             if (arg == "-d") {
             doFieldDump = true;
+        } else
+            if (arg == "-a") {
+            doDeleted = true;
         } else
             if (arg == "-c") {
             doColumnDump = true;
+        } else
+            if (arg == "-m") {
+            doMapped = true;
+        } else
+            if (arg == "-n") {
+            doNormalize = true;
+        } else
+            if (arg == "-p") {
+            doParquet = true;
+        } else
+            if ((arg == "--stats") || (arg == "--stats=json")) {
+            doStats = true;
+            doStatsJson = (arg == "--stats=json");
+        } else
+            if (arg == "-j") {
+            i++;
+            if (i < argc)
+                threads = strtoul(argv[i], NULL, 10);
+            else do_help();
+        } else
+            if (arg == "-r") {
+            i++;
+            if (i < argc)
+                readAhead = strtoul(argv[i], NULL, 10);
+            else do_help();
+        } else
+            if (arg == "-b") {
+            i++;
+            if (i < argc)
+                blockSize = strtoul(argv[i], NULL, 10) * 1024 * 1024;
+            else do_help();
+        } else
+            if (arg == "-g") {
+            i++;
+            if (i < argc) {
+                groupFields = argv[i];
+                doAggregate = true;
+            } else do_help();
+        } else
+            if (arg == "-t") {
+            i++;
+            if (i < argc) {
+                aggregates = argv[i];
+                doAggregate = true;
+            } else do_help();
         } else
             if (arg == "-w") {
             i++;
@@ -107,175 +353,947 @@ void setup(int argc, char* argv[]) {
 
     }
 
-    dbf.open(fileName);
+    if (fileNames.size() > 1) {
+        if (count(fileNames.begin(), fileNames.end(), "-") > 0) {
+            cout << "Can only read a single dbf from stdin." << endl;
+            exit(1);
+        }
+        if ((packFileName != "") || (indexBuildField != "")) {
+            cout << "Can only pack or index a single dbf." << endl;
+            exit(1);
+        }
+    }
+
+    if (!fileNames.empty())
+        fileName = fileNames[0];
+    else fileNames.push_back(fileName);
 
-    if (dbf.getStatus().error != dbf.STATUS_READY) {
-        cout << "Could not open " << fileName << "." << endl;
-        exit(dbf.getStatus().syserror);
+    if (!open_dbf()) {
+        cout << open_failure() << endl;
+        exit(dbf.getStatus().syserror ? dbf.getStatus().syserror : 1);
     }
 
-    fopt.open(fields, fields94, dbf);
+    dbf.setBlockSize(blockSize);
+
+    // The Parquet writer collects whole row groups and is not shared
+    if (doParquet)
+        threads = 1;
+
+    // The parallel workers already have a read each in flight
+    if (threads == 1)
+        dbf.setReadAhead(readAhead);
+
+    if (!resolve_fields()) {
+        cout << "Invalid filter: " << filter.getError() << "." << endl;
+        exit(1);
+    }
+    columns = plan;
+    accept_fields();
+
+    if (doAggregate) {
+        if (doParquet) {
+            cout << "Aggregates can only be output as text." << endl;
+            exit(1);
+        }
+        if (!totals.open(groupFields, aggregates, fopt, dbf)) {
+            cout << "Invalid aggregate: " << totals.getError() << "." << endl;
+            exit(1);
+        }
+    }
+
+    if (packFileName != "") {
+        dbf.pack(packFileName);
+        if (dbf.getStatus().error != DBFActor::STATUS_READY) {
+            cout << "Could not pack " << fileName << " into " << packFileName << "." << endl;
+            exit(1);
+        }
+        exit(0);
+    }
+
+    if (indexBuildField != "") {
+        if (dbf.isStream()) {
+            cout << "Could not build index: indexes need a dbf file." << endl;
+            exit(1);
+        }
+
+        DBFIndex index;
+        if (!index.build(dbf, fileName, indexBuildField)) {
+            cout << "Could not build index: " << index.getError() << "." << endl;
+            exit(1);
+        }
+        exit(0);
+    }
+}
+
+// Strips leading and trailing spaces from a field value
+
+string_view trim(string_view v) {
+    size_t first = v.find_first_not_of(' ');
+    if (first == string_view::npos)
+        return string_view();
+    return v.substr(first, v.find_last_not_of(' ') - first + 1);
 }
 
-string decodeB94(string b94) {
-    typedef unsigned long long uintXL;
+// Returns the base 94 value b94 as decimal text, kept in arena
 
-    const uintXL MAX_UINTXL = numeric_limits<uintXL>::max();
-    uintXL count = 0;
+string_view decodeB94(string_view b94, Arena &arena) {
+    uint64_t value;
 
-    for (uint i = 0; i < b94.length(); i++) {
-        uintXL val = (b94[i] - 33);
-        if (val > 93)
+    switch (decodeBase94(b94, value)) {
+        case B94_INVALID:
             return "INVALID";
-        if (count > (MAX_UINTXL / 94))
-            return "OVERFLOW";
-        count *= 94;
-        if ((MAX_UINTXL - count) < val)
+        case B94_OVERFLOW:
             return "OVERFLOW";
-        count += val;
     }
 
-    return to_string(count);
+    char *text = arena.alloc(20);
+    return string_view(text, to_chars(text, text + 20, value).ptr - text);
+}
+
+// Returns v with its double quotes doubled, kept in arena
+
+string_view double_quotes(string_view v, Arena &arena) {
+    char *text = arena.alloc(v.length() + count(v.begin(), v.end(), '"'));
+    char *end = text;
+
+    for (char c : v) {
+        *end++ = c;
+        if (c == '"')
+            *end++ = '"';
+    }
+
+    return string_view(text, end - text);
+}
+
+// Appends the base 94 value v padded to width, taking the value from
+// decoded when dump_block has already decoded the row
+
+void append_b94(OutputBuffer &out, string_view v, const B94Row *decoded, uint column, size_t width) {
+    uint64_t value;
+    uint8_t result;
+
+    if (decoded) {
+        value = decoded->values[column];
+        result = decoded->results[column];
+    } else result = decodeBase94(v, value);
+
+    if (result == B94_VALID)
+        out.appendPaddedNumber(value, width);
+    else if (result == B94_INVALID)
+        out.appendPadded("INVALID", width);
+    else out.appendPadded("OVERFLOW", width);
 }
 
 void field_dump() {
-    for (uint i = 1; i <= dbf.getFieldCount(); i++) {
-        cout << dbf.getField(i).fieldInfo.name << "[";
-        uint length = dbf.getField(i).fieldInfo.length;
-        cout << length << "]" << endl;
+    for (const DBFField &field : dbf.getFields()) {
+        output.append(field.fieldInfo.name);
+        output.put('[');
+        output.appendNumber(field.fieldInfo.length);
+        output.put(']');
+        output.endLine();
     }
+    output.flush();
     exit(0);
 }
 
-void column_dump() {
-    DBFRecord rec = dbf.getRecord();
+// Width of memo columns with -c, whose text is cut to fit on one line
+const uint MEMO_COLUMN_WIDTH = 41;
 
+void column_header(OutputBuffer &out) {
     if (indexFieldName != "")
-        cout << left << setw(indexFieldName.length() + 1) << indexFieldName;
-
-    for (uint i = 1; i <= dbf.getFieldCount(); i++) {
-        string f = dbf.getField(i).fieldInfo.name;
-        transform(f.begin(), f.end(), f.begin(), ::toupper);
-        if (fopt.wants(f)) {
-            uint length = dbf.getField(i).fieldInfo.length + 1;
-            if (length < 12)
-                length = 12;
-            if (fopt.wantsB94(f))
-                length = 21;
-            cout << left << setw(length) << dbf.getField(i).fieldInfo.name;
+        out.appendPadded(indexFieldName, indexFieldName.length() + 1);
+
+    for (const FieldSelection &sel : plan) {
+        uint length = sel.field.fieldInfo.length + 1;
+        if (length < 12)
+            length = 12;
+        if (doNormalize && (length < normalizedLength(sel.field) + 1))
+            length = normalizedLength(sel.field) + 1;
+        if (sel.b94)
+            length = 21;
+        else if (fieldIsMemo(sel.field))
+            length = MEMO_COLUMN_WIDTH;
+        widths.push_back(length);
+        out.appendPadded(sel.name, length);
+    }
+
+    out.endLine();
+}
+
+// Returns the value of a selected field as it is output, before any base 94
+// decoding. Memo fields give the memo text. buf must hold
+// NORMALIZE_BUFFER_SIZE bytes.
+
+string_view field_value(const FieldSelection &sel, const DBFRecordView &rec, char *buf) {
+    if (!sel.b94 && fieldIsMemo(sel.field))
+        return dbf.getMemo(rec, sel.field);
+    if (doNormalize && !sel.b94)
+        return normalizeField(sel.field, rec.get(sel.field), buf);
+    return trim(rec.get(sel.field));
+}
+
+// Appends memo text padded to width, cut short to leave a space before the
+// next column and with line breaks and tabs turned into spaces
+
+void append_memo_column(OutputBuffer &out, string_view v, size_t width) {
+    char line[MEMO_COLUMN_WIDTH];
+    size_t len = min(v.length(), min(width, sizeof (line)) - 1);
+
+    for (size_t i = 0; i < len; i++)
+        line[i] = ((v[i] == '\r') || (v[i] == '\n') || (v[i] == '\t')) ? ' ' : v[i];
+
+    out.appendPadded(string_view(line, len), width);
+}
+
+void column_row(OutputBuffer &out, const DBFRecordView &rec, unsigned long long count, const B94Row *decoded) {
+    char buf[NORMALIZE_BUFFER_SIZE];
+    uint b94 = 0;
+
+    if (indexFieldName != "")
+        out.appendPaddedNumber(count, indexFieldName.length() + 1);
+
+    for (uint i = 0; i < plan.size(); i++) {
+        string_view v = field_value(plan[i], rec, buf);
+
+        if (plan[i].b94)
+            append_b94(out, v, decoded, b94++, widths[i]);
+        else if (fieldIsMemo(plan[i].field))
+            append_memo_column(out, v, widths[i]);
+        else out.appendPadded(v, widths[i]);
+    }
+
+    out.endLine();
+}
+
+void delim_header(OutputBuffer &out) {
+    bool first_field = true;
+
+    if (indexFieldName != "") {
+        out.append(indexFieldName);
+        out.append(delim);
+    }
+
+    for (const FieldSelection &sel : plan) {
+        if (first_field)
+            first_field = false;
+        else out.append(delim);
+        out.append(sel.name);
+    }
+
+    out.endLine();
+}
+
+void delim_row(OutputBuffer &out, const DBFRecordView &rec, unsigned long long count, const B94Row *decoded, Arena &arena) {
+    char buf[NORMALIZE_BUFFER_SIZE];
+    bool first_field = true;
+    uint b94 = 0;
+
+    if (indexFieldName != "") {
+        out.appendNumber(count);
+        out.append(delim);
+    }
+
+    for (const FieldSelection &sel : plan) {
+        if (first_field)
+            first_field = false;
+        else out.append(delim);
+
+        string_view v = field_value(sel, rec, buf);
+        uint column = sel.b94 ? b94++ : 0;
+
+        // Memo text can also hold quotes and line breaks
+        bool quote = (v.find(delim) != string_view::npos) ||
+                (!sel.b94 && fieldIsMemo(sel.field) && (v.find_first_of("\"\r\n") != string_view::npos));
+
+        if (!quote) {
+            if (sel.b94)
+                append_b94(out, v, decoded, column, 0);
+            else out.append(v);
+            continue;
         }
+
+        // Values holding the delimiter are quoted, with embedded quotes doubled
+        out.put('"');
+        if (sel.b94 && (v.find('"') != string_view::npos))
+            out.append(decodeB94(double_quotes(v, arena), arena));
+        else if (sel.b94)
+            append_b94(out, v, decoded, column, 0);
+        else out.appendEscaped(v, '"');
+        out.put('"');
     }
 
-    cout << endl;
+    out.endLine();
+}
+
+// Returns the Parquet column type a selected field is written as
+
+int parquet_kind(const FieldSelection &sel) {
+    if (sel.b94)
+        return ParquetWriter::COLUMN_STRING;
+
+    const DBFFieldInfo &info = sel.field.fieldInfo;
+
+    switch (toupper(info.type)) {
+        case 'N':
+            if ((info.decimalCount == 0) && (info.length <= 18))
+                return ParquetWriter::COLUMN_INT64;
+            return ParquetWriter::COLUMN_DOUBLE;
+        case 'F':
+            return ParquetWriter::COLUMN_DOUBLE;
+        case 'I':
+            if (info.length == 4)
+                return ParquetWriter::COLUMN_INT32;
+            break;
+        case 'B':
+        case 'Y':
+            if (info.length == 8)
+                return ParquetWriter::COLUMN_DOUBLE;
+            break;
+        case 'D':
+            return ParquetWriter::COLUMN_DATE;
+        case 'T':
+            return ParquetWriter::COLUMN_TIMESTAMP;
+        case 'L':
+            return ParquetWriter::COLUMN_BOOL;
+    }
+
+    return ParquetWriter::COLUMN_STRING;
+}
+
+void parquet_header() {
+    if (indexFieldName != "")
+        parquet.addColumn(indexFieldName, ParquetWriter::COLUMN_INT64);
+
+    for (const FieldSelection &sel : plan) {
+        kinds.push_back(parquet_kind(sel));
+        parquet.addColumn(sel.name, kinds.back());
+    }
+
+    parquet.begin();
+}
+
+// Typed columns get nulls for blank or malformed values
+
+void parquet_row(const DBFRecordView &rec, unsigned long long count, Arena &arena) {
+    char buf[NORMALIZE_BUFFER_SIZE];
+    size_t column = 0;
 
-    unsigned long long count = 1;
+    if (indexFieldName != "")
+        parquet.putInt64(column++, count);
+
+    for (uint i = 0; i < plan.size(); i++, column++) {
+        const FieldSelection &sel = plan[i];
+        int64_t l;
+        double d;
+        bool b;
+        DBFDateTime dt;
 
-    while (dbf.getStatus().error == dbf.STATUS_READY) {
-        if (indexFieldName != "") {
-            cout << left << setw(indexFieldName.length() + 1) << count;
-            count++;
+        switch (kinds[i]) {
+            case ParquetWriter::COLUMN_INT64:
+                if (rec.getInt64(sel.field, l))
+                    parquet.putInt64(column, l);
+                else parquet.putNull(column);
+                break;
+            case ParquetWriter::COLUMN_INT32:
+                if (rec.getInt64(sel.field, l))
+                    parquet.putInt32(column, l);
+                else parquet.putNull(column);
+                break;
+            case ParquetWriter::COLUMN_DOUBLE:
+                if (rec.getDouble(sel.field, d))
+                    parquet.putDouble(column, d);
+                else parquet.putNull(column);
+                break;
+            case ParquetWriter::COLUMN_BOOL:
+                if (rec.getBool(sel.field, b))
+                    parquet.putBool(column, b);
+                else parquet.putNull(column);
+                break;
+            case ParquetWriter::COLUMN_DATE:
+                if (rec.getDate(sel.field, dt.date))
+                    parquet.putInt32(column, daysSinceEpoch(dt.date));
+                else parquet.putNull(column);
+                break;
+            case ParquetWriter::COLUMN_TIMESTAMP:
+                if (rec.getDateTime(sel.field, dt))
+                    parquet.putInt64(column, daysSinceEpoch(dt.date) * 86400000LL + dt.millis);
+                else parquet.putNull(column);
+                break;
+            default:
+                if (sel.b94)
+                    parquet.putString(column, decodeB94(field_value(sel, rec, buf), arena));
+                else parquet.putString(column, field_value(sel, rec, buf));
         }
+    }
+
+    parquet.endRow();
+}
+
+// Formats rec, keeping any text made on the way in arena
+
+void dump_row(OutputBuffer &out, const DBFRecordView &rec, unsigned long long count, const B94Row *decoded, Arena &arena) {
+    if (doParquet)
+        parquet_row(rec, count, arena);
+    else if (doColumnDump)
+        column_row(out, rec, count, decoded);
+    else delim_row(out, rec, count, decoded, arena);
+}
+
+// Formats the records of block that match the filter and aren't deleted,
+// stopping before record end. The -9 columns of those records are decoded a
+// column at a time first.
 
-        for (uint i = 1; i <= dbf.getFieldCount(); i++) {
-            string f = dbf.getField(i).fieldInfo.name;
-            uint length = dbf.getField(i).fieldInfo.length + 1;
-            if (length < 12)
-                length = 12;
-            transform(f.begin(), f.end(), f.begin(), ::toupper);
-            if (fopt.wants(f)) {
-                string v = rec.get(dbf.getField(i).fieldInfo.name);
-                v.erase(0, v.find_first_not_of(" "));
-                v.erase(v.find_last_not_of(" ") + 1);
-
-                if (fopt.wantsB94(f))
-                    cout << left << setw(21) << decodeB94(v);
-                else cout << left << setw(length) << v;
+void dump_block(OutputBuffer &out, const DBFBlock &block, uint32_t end, BlockScratch &scratch) {
+    uint32_t count = min(block.count, end - block.first);
+    uint32_t deleted = 0;
+    uint32_t emitted = 0;
 
+    scratch.arena.reset();
+    filter.matchBlock(block, scratch.hits);
+
+    if (!doDeleted) {
+        for (uint32_t i = 0; i < block.count; i++) {
+            if (block.deleted(i)) {
+                scratch.hits[i] = 0;
+                if (i < count)
+                    deleted++;
             }
         }
+    }
+
+    bool batch = (b94Columns > 0) && !doParquet && !doAggregate;
 
-        rec = dbf.getRecord();
-        cout << endl;
+    if (batch) {
+        scratch.b94Values.resize(block.count * b94Columns);
+        scratch.b94Results.resize(block.count * b94Columns);
+
+        uint column = 0;
+        for (const FieldSelection &sel : plan) {
+            if (sel.b94) {
+                decodeBase94Block(block, sel.field.fieldOffset, sel.field.fieldInfo.length,
+                        scratch.hits, &scratch.b94Values[column], &scratch.b94Results[column],
+                        b94Columns);
+                column++;
+            }
+        }
     }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (!scratch.hits[i])
+            continue;
+
+        emitted++;
+        if (doAggregate) {
+            scratch.partial.add(block.record(i));
+            continue;
+        }
+
+        B94Row decoded = {scratch.b94Values.data() + i * b94Columns,
+            scratch.b94Results.data() + i * b94Columns};
+        dump_row(out, block.record(i), block.first + i + 1ULL, batch ? &decoded : nullptr, scratch.arena);
+    }
+
+    scratch.stats.scanned += count;
+    scratch.stats.deleted += deleted;
+    scratch.stats.filtered += count - deleted - emitted;
+    scratch.stats.emitted += emitted;
 }
 
-void delim_dump(string delim) {
-    DBFRecord rec = dbf.getRecord();
-    bool first_field = true;
+// Appends value number column of an aggregate row, padded with -c, or else
+// after a delimiter and quoted if it holds one
 
-    if (indexFieldName != "")
-        cout << indexFieldName << delim;
-
-    for (uint i = 1; i <= dbf.getFieldCount(); i++) {
-        string f = dbf.getField(i).fieldInfo.name;
-        transform(f.begin(), f.end(), f.begin(), ::toupper);
-        if (fopt.wants(f)) {
-            if (first_field)
-                first_field = false;
-            else cout << delim;
-            cout << dbf.getField(i).fieldInfo.name;
+void aggregate_cell(OutputBuffer &out, string_view v, size_t column) {
+    if (doColumnDump) {
+        out.appendPadded(v, widths[column]);
+        return;
+    }
+
+    if (column > 0)
+        out.append(delim);
+
+    if (v.find(delim) == string_view::npos)
+        out.append(v);
+    else {
+        out.put('"');
+        out.appendEscaped(v, '"');
+        out.put('"');
+    }
+}
+
+void aggregate_header(OutputBuffer &out) {
+    size_t column = 0;
+
+    for (const FieldSelection &sel : totals.getGroupBy()) {
+        uint length = sel.field.fieldInfo.length + 1;
+        if (length < 12)
+            length = 12;
+        if (doNormalize && (length < normalizedLength(sel.field) + 1))
+            length = normalizedLength(sel.field) + 1;
+        if (sel.b94)
+            length = 21;
+        widths.push_back(max<uint>(length, sel.name.length() + 1));
+        aggregate_cell(out, sel.name, column++);
+    }
+
+    for (const Aggregator::Column &c : totals.getColumns()) {
+        widths.push_back(max<uint>(21, c.name.length() + 1));
+        aggregate_cell(out, c.name, column++);
+    }
+
+    out.endLine();
+}
+
+// Returns the raw field value of a group key or a MIN or MAX as it is
+// output. The Visual FoxPro binary types are always normalized.
+
+string_view aggregate_text(const DBFField &field, string_view raw, char *buf) {
+    switch (toupper(field.fieldInfo.type)) {
+        case 'I':
+        case 'B':
+        case 'Y':
+        case 'T':
+            return normalizeField(field, raw, buf);
+    }
+
+    if (doNormalize)
+        return normalizeField(field, raw, buf);
+    return trim(raw);
+}
+
+// Writes value into buf as decimal text and returns its length
+
+int int128_text(__int128 value, char *buf) {
+    unsigned __int128 u = (value < 0) ? -(unsigned __int128) value : value;
+    char digits[40];
+    int count = 0;
+    int n = 0;
+
+    do {
+        digits[count++] = '0' + (int) (u % 10);
+        u /= 10;
+    } while (u > 0);
+
+    if (value < 0)
+        buf[n++] = '-';
+    while (count > 0)
+        buf[n++] = digits[--count];
+
+    return n;
+}
+
+// Returns a SUM, MIN or MAX as it is output, empty if the group had no
+// values for it. Sums of fractional numbers keep the decimals of the field.
+
+string_view aggregate_value(const Aggregator::Column &c, const Aggregator::Value &v, char *buf) {
+    if (!v.set)
+        return string_view();
+
+    if (c.op != Aggregator::AGG_SUM)
+        return aggregate_text(c.field, v.raw, buf);
+
+    int n;
+    if ((c.kind == Aggregator::KIND_INTEGER) && v.wide)
+        n = int128_text(v.wideSum, buf);
+    else if (c.kind == Aggregator::KIND_INTEGER)
+        n = snprintf(buf, NORMALIZE_BUFFER_SIZE, "%lld", (long long) v.sum);
+    else if (toupper(c.field.fieldInfo.type) == 'Y')
+        n = snprintf(buf, NORMALIZE_BUFFER_SIZE, "%.4f", v.number);
+    else if (c.field.fieldInfo.decimalCount > 0)
+        n = snprintf(buf, NORMALIZE_BUFFER_SIZE, "%.*f", (int) c.field.fieldInfo.decimalCount, v.number);
+    else n = snprintf(buf, NORMALIZE_BUFFER_SIZE, "%.15g", v.number);
+
+    return string_view(buf, min<size_t>(n, NORMALIZE_BUFFER_SIZE - 1));
+}
+
+// Outputs the aggregated groups ordered by their raw keys. Without group
+// fields there is a single row, even when no records matched.
+
+void aggregate_dump(OutputBuffer &out) {
+    typedef pair<const string, Aggregator::Group> Entry;
+
+    const FieldPlan &groupBy = totals.getGroupBy();
+    const vector<Aggregator::Column> &aggs = totals.getColumns();
+    vector<const Entry *> rows;
+    char buf[NORMALIZE_BUFFER_SIZE];
+    Arena arena;
+
+    for (const Entry &e : totals.getGroups())
+        rows.push_back(&e);
+    sort(rows.begin(), rows.end(), [](const Entry *a, const Entry *b) {
+        return a->first < b->first;
+    });
+
+    Aggregator::Group none;
+    none.count = 0;
+    none.values.resize(aggs.size());
+    Entry empty("", none);
+    if (rows.empty() && groupBy.empty())
+        rows.push_back(&empty);
+
+    for (const Entry *e : rows) {
+        size_t column = 0;
+
+        for (size_t i = 0; i < groupBy.size(); i++) {
+            string_view raw = totals.groupValue(e->first, i);
+
+            if (groupBy[i].b94)
+                aggregate_cell(out, decodeB94(trim(raw), arena), column++);
+            else aggregate_cell(out, aggregate_text(groupBy[i].field, raw, buf), column++);
         }
+
+        for (size_t i = 0; i < aggs.size(); i++) {
+            if (aggs[i].op == Aggregator::AGG_COUNT)
+                aggregate_cell(out, to_string(e->second.count), column++);
+            else aggregate_cell(out, aggregate_value(aggs[i], e->second.values[i], buf), column++);
+        }
+
+        out.endLine();
+        arena.reset();
     }
+}
 
-    cout << endl;
+// Returns the comparison of a filter that is a single =, ^= or range
+// comparison on a non numeric field, the only ones an index can answer, or
+// NULL if the filter is anything else
+
+const RecordFilter::Node *index_node() {
+    const vector<RecordFilter::Node> &nodes = filter.getNodes();
+
+    if ((nodes.size() != 1) || nodes[0].numeric)
+        return NULL;
+
+    const RecordFilter::Node &n = nodes[0];
 
-    unsigned long long count = 1;
+    if ((n.op != RecordFilter::OP_EQ) && (n.op != RecordFilter::OP_PREFIX) && (n.op != RecordFilter::OP_RANGE))
+        return NULL;
 
-    while (dbf.getStatus().error == dbf.STATUS_READY) {
-        first_field = true;
-        if (indexFieldName != "") {
-            cout << count << delim;
-            count++;
+    return &n;
+}
+
+// Looks the records up in a sidecar index when the filter is one index_node()
+// accepts and the field has an up to date index. Returns false if the filter
+// can't be answered from an index.
+
+bool index_lookup(vector<uint32_t> &records) {
+    const RecordFilter::Node *node = index_node();
+
+    if ((node == NULL) || dbf.isStream())
+        return false;
+
+    const RecordFilter::Node &n = *node;
+
+    DBFIndex index;
+    if (!index.open(dbf, fileName, n.field.fieldInfo.name))
+        return false;
+
+    if (n.op == RecordFilter::OP_EQ)
+        records = index.find(n.value);
+    else if (n.op == RecordFilter::OP_PREFIX)
+        records = index.findPrefix(n.value);
+    else records = index.findRange(n.value, n.high);
+
+    return true;
+}
+
+void index_dump(const vector<uint32_t> &records) {
+    Arena arena;
+
+    for (uint32_t r : records) {
+        uint64_t start = nanoTime();
+        DBFRecordView rec = dbf.getRecordView(r);
+        uint64_t read = nanoTime();
+
+        stats.readNanos += read - start;
+        stats.scanned++;
+
+        if (!rec.valid())
+            continue;
+        if (!doDeleted && rec.deleted()) {
+            stats.deleted++;
+            continue;
         }
-        for (uint i = 1; i <= dbf.getFieldCount(); i++) {
-            string f = dbf.getField(i).fieldInfo.name;
-            transform(f.begin(), f.end(), f.begin(), ::toupper);
-            if (fopt.wants(f)) {
-                if (first_field)
-                    first_field = false;
-                else cout << delim;
-
-                string v = rec.get(dbf.getField(i).fieldInfo.name);
-                v.erase(0, v.find_first_not_of(" "));
-                v.erase(v.find_last_not_of(" ") + 1);
-
-                bool has_delim = v.find(delim) != string::npos;
-
-                if (has_delim && (v.find("\"") != string::npos)) {
-                    for (uint i = 0; i < v.length(); i++) {
-                        if (v[i] == '\"') {
-                            v.insert(i, "\"");
-                            i++;
-                        }
-                    }
+
+        uint64_t written = output.writeNanos();
+        if (doAggregate)
+            totals.add(rec);
+        else dump_row(output, rec, r + 1ULL, nullptr, arena);
+        arena.reset();
+        stats.formatNanos += (nanoTime() - read) - (output.writeNanos() - written);
+        stats.emitted++;
+    }
+}
+
+void dump() {
+    BlockScratch scratch;
+    scratch.partial.reset(totals);
+
+    uint64_t start = nanoTime();
+    DBFBlock block = dbf.readBlock();
+    uint64_t read = nanoTime();
+
+    while (block.count > 0) {
+        uint64_t written = output.writeNanos();
+
+        scratch.stats.readNanos += read - start;
+        dump_block(output, block, UINT32_MAX, scratch);
+        start = nanoTime();
+        scratch.stats.formatNanos += (start - read) - (output.writeNanos() - written);
+        block = dbf.readBlock();
+        read = nanoTime();
+    }
+
+    scratch.stats.readNanos += read - start;
+    stats.add(scratch.stats);
+    totals.merge(scratch.partial);
+}
+
+// Formats files, all with the field descriptors of dbf and records[i]
+// records long, in chunks of one read block each on threads workers, each
+// with its own DBFActor, and writes the chunks out in order, file by file.
+// Workers move on to whichever file the next chunk is from, so every file
+// is spread over all of them. Rows are numbered by record number within
+// their file, the same as the sequential dump. Returns false if a file
+// couldn't be read.
+
+bool parallel_dump(const vector<string> &files, const vector<uint32_t> &records) {
+    vector<unique_ptr<DBFActor>> readers;
+    vector<int> readerFile(threads, -1);
+    vector<OutputBuffer> buffers(threads);
+    vector<BlockScratch> scratch(threads);
+    vector<bool> unreadable(files.size(), false);
+    mutex unreadableLock;
+
+    for (uint i = 0; i < threads; i++) {
+        readers.push_back(unique_ptr<DBFActor>(new DBFActor()));
+        readers[i]->setBlockSize(blockSize);
+        scratch[i].partial.reset(totals);
+    }
+
+    uint16_t recordLength = dbf.getHeader().recordLength;
+    uint32_t chunkRecords = recordLength ? blockSize / recordLength : 1;
+
+    parallelScan(records, chunkRecords, threads,
+            [&](unsigned worker, const ScanChunk &chunk, string &out) {
+                DBFActor &reader = *readers[worker];
+                OutputBuffer &buf = buffers[worker];
+                uint32_t first = chunk.first;
+                uint32_t end = first + chunk.count;
+
+                ScanStats &counts = scratch[worker].stats;
+
+                // The files share their field descriptors, so reopening
+                // doesn't parse them again
+                if (readerFile[worker] != (int) chunk.file) {
+                    counts.addIO(reader.getIOStats());
+                    if (doMapped)
+                        reader.openMapped(files[chunk.file]);
+                    else reader.open(files[chunk.file]);
+                    readerFile[worker] = chunk.file;
                 }
 
-                if (has_delim)
-                    cout << "\"";
+                buf.swap(out);
+                reader.seekRecord(first);
 
-                if (fopt.wantsB94(f))
-                    cout << decodeB94(v);
-                else cout << v;
+                while (first < end) {
+                    uint64_t start = nanoTime();
+                    DBFBlock block = reader.readBlock();
+                    uint64_t read = nanoTime();
 
-                if (has_delim)
-                    cout << "\"";
-            }
+                    counts.readNanos += read - start;
+                    if (block.count == 0)
+                        break;
+                    dump_block(buf, block, end, scratch[worker]);
+                    counts.formatNanos += nanoTime() - read;
+                    first = block.first + block.count;
+                }
+
+                buf.swap(out);
+
+                if (reader.getStatus().error != DBFActor::STATUS_READY) {
+                    lock_guard<mutex> guard(unreadableLock);
+                    unreadable[chunk.file] = true;
+                }
+            },
+            [](const string &out) {
+                output.append(out);
+            });
+
+    bool ok = true;
+
+    for (uint i = 0; i < threads; i++) {
+        stats.add(scratch[i].stats);
+        stats.addIO(readers[i]->getIOStats());
+        totals.merge(scratch[i].partial);
+    }
+
+    for (size_t i = 0; i < files.size(); i++) {
+        if (unreadable[i]) {
+            cerr << "Could not read " << files[i] << "." << endl;
+            ok = false;
         }
+    }
+
+    return ok;
+}
+
+// Collects fileNames[first], open in dbf, and the files after it that
+// parallel_dump can take along with it: those with the same field
+// descriptors as the last accepted file that aren't compressed. Memo text is
+// read through dbf, so with memo fields selected each file is dumped on its
+// own. Only the first file of a run is looked up in an index, so a run also
+// stops at a file with an index on the filter field.
 
-        rec = dbf.getRecord();
-        cout << endl;
+void schema_run(size_t first, vector<string> &files, vector<uint32_t> &records) {
+    files.assign(1, fileNames[first]);
+    records.assign(1, dbf.length());
+
+    for (const FieldSelection &sel : plan) {
+        if (!sel.b94 && fieldIsMemo(sel.field))
+            return;
     }
 
+    const RecordFilter::Node *indexed = index_node();
+    DBFActor probe;
+
+    for (size_t i = first + 1; i < fileNames.size(); i++) {
+        probe.open(fileNames[i]);
+        stats.addIO(probe.getIOStats());
+
+        if ((probe.getStatus().error != DBFActor::STATUS_READY) || probe.isStream() ||
+                (probe.getDescriptors() != accepted.descriptors))
+            break;
+
+        if ((indexed != NULL) &&
+                (access(DBFIndex::fileName(fileNames[i], indexed->field.fieldInfo.name).c_str(), F_OK) == 0))
+            break;
+
+        files.push_back(fileNames[i]);
+        records.push_back(probe.length());
+    }
+}
+
+// True if the selected fields of plan come out as the same columns as the
+// first file's
+
+bool same_columns(const FieldPlan &plan) {
+    if (plan.size() != columns.size())
+        return false;
+
+    for (size_t i = 0; i < plan.size(); i++) {
+        if ((strcasecmp(plan[i].name.c_str(), columns[i].name.c_str()) != 0) || (plan[i].b94 != columns[i].b94))
+            return false;
+        if (doParquet && (parquet_kind(plan[i]) != parquet_kind(columns[i])))
+            return false;
+    }
+
+    return true;
+}
+
+// Opens the next of several files. The fields are only resolved again if
+// its field descriptors differ from the last file accepted, and then have
+// to give the same columns as the first file. Returns false with a message
+// on stderr if the file can't be dumped, leaving the fields of the last
+// accepted file in place.
+
+bool next_file(const string &name) {
+    fileName = name;
+
+    if (!open_dbf()) {
+        cerr << open_failure() << endl;
+        return false;
+    }
+
+    if (dbf.getDescriptors() == accepted.descriptors)
+        return true;
+
+    if (!resolve_fields()) {
+        cerr << "Invalid filter for " << fileName << ": " << filter.getError() << "." << endl;
+        restore_fields();
+        return false;
+    }
+
+    // Only the aggregated fields are output
+    if (doAggregate) {
+        if (!totals.resolve(dbf)) {
+            cerr << "Can't aggregate " << fileName << ": " << totals.getError() << "." << endl;
+            restore_fields();
+            return false;
+        }
+    } else if (!same_columns(plan)) {
+        cerr << fileName << " does not have the same fields as " << fileNames[0] << "." << endl;
+        restore_fields();
+        return false;
+    }
+
+    accept_fields();
+    return true;
 }
 
 int main(int argc, char* argv[]) {
+    uint64_t start = nanoTime();
+
     setup(argc, argv);
     if (doFieldDump)
         field_dump();
+
+    if (doAggregate)
+        aggregate_header(output);
+    else if (doParquet)
+        parquet_header();
     else if (doColumnDump)
-        column_dump();
-    else delim_dump(",");
-    return 0;
+        column_header(output);
+    else delim_header(output);
+
+    bool failed = false;
+    uint64_t allocations = heapAllocations();
+
+    for (size_t i = 0; i < fileNames.size(); i++) {
+        if ((i > 0) && !next_file(fileNames[i])) {
+            failed = true;
+            continue;
+        }
+
+        vector<uint32_t> records;
+
+        // The workers each need to reopen and seek the file, which streams
+        // can't do
+        if (index_lookup(records))
+            index_dump(records);
+        else if ((threads > 1) && !dbf.isStream()) {
+            vector<string> files;
+
+            schema_run(i, files, records);
+            if (!parallel_dump(files, records))
+                failed = true;
+            i += files.size() - 1;
+        } else dump();
+
+        stats.addIO(dbf.getIOStats());
+
+        // Streams, compressed files in particular, can fail part way through
+        if (dbf.getStatus().error != DBFActor::STATUS_READY) {
+            cerr << "Could not read " << fileName << "." << endl;
+            failed = true;
+        }
+    }
+
+    stats.allocations = heapAllocations() - allocations;
+
+    if (doAggregate)
+        aggregate_dump(output);
+    else if (doParquet)
+        parquet.finish();
+
+    output.flush();
+
+    if (doStats) {
+        stats.writeNanos = output.writeNanos();
+        stats.bytesWritten = output.bytesWritten();
+        stats.totalNanos = nanoTime() - start;
+        printStats(cerr, stats, threads, doStatsJson);
+    }
+
+    return (failed || output.fail()) ? 1 : 0;
 }
 
 
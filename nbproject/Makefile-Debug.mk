@@ -14,6 +14,7 @@ GREP=grep
 NM=nm
 CCADMIN=CCadmin
 RANLIB=ranlib
+AR=ar
 CC=gcc
 CCC=g++
 CXX=g++
@@ -35,18 +36,44 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/Aggregator.o \
+	${OBJECTDIR}/Arena.o \
+	${OBJECTDIR}/Base94.o \
 	${OBJECTDIR}/DBFActor.o \
+	${OBJECTDIR}/DBFIndex.o \
 	${OBJECTDIR}/DBFRecord.o \
+	${OBJECTDIR}/Decompressor.o \
+	${OBJECTDIR}/FieldDecode.o \
 	${OBJECTDIR}/FieldOptions.o \
+	${OBJECTDIR}/FieldScan.o \
+	${OBJECTDIR}/HeapCounter.o \
+	${OBJECTDIR}/MemoFile.o \
+	${OBJECTDIR}/OutputBuffer.o \
+	${OBJECTDIR}/ParallelScan.o \
+	${OBJECTDIR}/ParquetWriter.o \
+	${OBJECTDIR}/ReadAhead.o \
+	${OBJECTDIR}/RecordFilter.o \
+	${OBJECTDIR}/ScanStats.o \
 	${OBJECTDIR}/main.o
 
+# Benchmark Object Files
+BENCHOBJECTFILES= \
+	${OBJECTDIR}/DBFBench.o \
+	${OBJECTDIR}/DBFGenerator.o
+
+# Library Object Files
+LIBOBJECTFILES= \
+	${OBJECTDIR}/DBFApi.o
+
+# The library leaves operator new to the program it is linked into
+LIBLINKOBJECTFILES=${LIBOBJECTFILES} $(filter-out ${OBJECTDIR}/main.o ${OBJECTDIR}/HeapCounter.o,${OBJECTFILES})
 
 # C Compiler Flags
 CFLAGS=
 
 # CC Compiler Flags
-CCFLAGS=
-CXXFLAGS=
+CCFLAGS=-std=c++17 -pthread -fPIC
+CXXFLAGS=-std=c++17 -pthread -fPIC
 
 # Fortran Compiler Flags
 FFLAGS=
@@ -55,7 +82,7 @@ FFLAGS=
 ASFLAGS=
 
 # Link Libraries and Options
-LDLIBSOPTIONS=
+LDLIBSOPTIONS=-pthread -lz
 
 # Build Targets
 .build-conf: ${BUILD_SUBPROJECTS}
@@ -65,21 +92,134 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbftool: ${OBJECTFILES}
 	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
 	${LINK.cc} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbftool ${OBJECTFILES} ${LDLIBSOPTIONS}
 
+# Library Targets
+.lib-conf: ${BUILD_SUBPROJECTS}
+	"${MAKE}"  -f nbproject/Makefile-${CND_CONF}.mk ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.a ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.${CND_DLIB_EXT}
+
+${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.a: ${LIBLINKOBJECTFILES}
+	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
+	${RM} ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.a
+	${AR} -rv ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.a ${LIBLINKOBJECTFILES}
+	$(RANLIB) ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.a
+
+${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.${CND_DLIB_EXT}: ${LIBLINKOBJECTFILES}
+	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
+	${LINK.cc} -shared -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.${CND_DLIB_EXT} ${LIBLINKOBJECTFILES} ${LDLIBSOPTIONS}
+
+# Benchmark Targets
+.bench-conf: .build-conf
+	"${MAKE}"  -f nbproject/Makefile-${CND_CONF}.mk ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbfbench
+	${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbfbench ${BENCHARGS}
+
+${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbfbench: ${BENCHOBJECTFILES} ${OBJECTFILES}
+	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
+	${LINK.cc} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbfbench ${BENCHOBJECTFILES} $(filter-out ${OBJECTDIR}/main.o,${OBJECTFILES}) ${LDLIBSOPTIONS}
+
+${OBJECTDIR}/Aggregator.o: Aggregator.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Aggregator.o Aggregator.cpp
+
+${OBJECTDIR}/Arena.o: Arena.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Arena.o Arena.cpp
+
+${OBJECTDIR}/Base94.o: Base94.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Base94.o Base94.cpp
+
 ${OBJECTDIR}/DBFActor.o: DBFActor.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DBFActor.o DBFActor.cpp
 
+${OBJECTDIR}/DBFApi.o: DBFApi.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DBFApi.o DBFApi.cpp
+
+${OBJECTDIR}/DBFBench.o: DBFBench.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DBFBench.o DBFBench.cpp
+
+${OBJECTDIR}/DBFGenerator.o: DBFGenerator.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DBFGenerator.o DBFGenerator.cpp
+
+${OBJECTDIR}/DBFIndex.o: DBFIndex.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DBFIndex.o DBFIndex.cpp
+
 ${OBJECTDIR}/DBFRecord.o: DBFRecord.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DBFRecord.o DBFRecord.cpp
 
+${OBJECTDIR}/Decompressor.o: Decompressor.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Decompressor.o Decompressor.cpp
+
+${OBJECTDIR}/FieldDecode.o: FieldDecode.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FieldDecode.o FieldDecode.cpp
+
 ${OBJECTDIR}/FieldOptions.o: FieldOptions.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FieldOptions.o FieldOptions.cpp
 
+${OBJECTDIR}/FieldScan.o: FieldScan.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FieldScan.o FieldScan.cpp
+
+${OBJECTDIR}/HeapCounter.o: HeapCounter.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/HeapCounter.o HeapCounter.cpp
+
+${OBJECTDIR}/MemoFile.o: MemoFile.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MemoFile.o MemoFile.cpp
+
+${OBJECTDIR}/OutputBuffer.o: OutputBuffer.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/OutputBuffer.o OutputBuffer.cpp
+
+${OBJECTDIR}/ParallelScan.o: ParallelScan.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ParallelScan.o ParallelScan.cpp
+
+${OBJECTDIR}/ParquetWriter.o: ParquetWriter.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ParquetWriter.o ParquetWriter.cpp
+
+${OBJECTDIR}/ReadAhead.o: ReadAhead.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ReadAhead.o ReadAhead.cpp
+
+${OBJECTDIR}/RecordFilter.o: RecordFilter.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/RecordFilter.o RecordFilter.cpp
+
+${OBJECTDIR}/ScanStats.o: ScanStats.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ScanStats.o ScanStats.cpp
+
 ${OBJECTDIR}/main.o: main.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -92,6 +232,9 @@ ${OBJECTDIR}/main.o: main.cpp
 .clean-conf: ${CLEAN_SUBPROJECTS}
 	${RM} -r ${CND_BUILDDIR}/${CND_CONF}
 	${RM} ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbftool
+	${RM} ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/dbfbench
+	${RM} ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.a
+	${RM} ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libdbftool.${CND_DLIB_EXT}
 
 # Subprojects
 .clean-subprojects: